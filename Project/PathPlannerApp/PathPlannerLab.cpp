@@ -21,6 +21,7 @@
 #include <map>
 #include <shobjidl_core.h>
 #include <functional>
+#include "../PathSearch/Benchmark.h"
 #include "PathPlannerUtility.h"
 #include "PathPlannerLab.h"
 
@@ -1298,6 +1299,15 @@ DWORD APIENTRY plannerThread(LPVOID unused)
 	return 0;
 }
 
+DWORD APIENTRY benchmarkThread(LPVOID unused)
+{
+	// Runs on generated maps, so the loaded map and planners are left alone.
+	std::cout << "Running benchmarks..." << std::endl;
+	fullsail_ai::algorithms::runBenchmarks(std::cout);
+	std::cout << "Benchmarks done." << std::endl;
+	return 0;
+}
+
 CriticalSectionSynchronizer::CriticalSectionSynchronizer() : cs_()
 {
 	InitializeCriticalSection(&cs_);
@@ -1377,6 +1387,7 @@ PathPlannerLab::PathPlannerLab()
 	, thread_sync_()
 	, thread_id_(0)
 	, thread_handle_(CreateThread(0, 0, plannerThread, 0, CREATE_SUSPENDED, &thread_id_))
+	, benchmark_thread_handle_(0)
 	, ground_up_tile_map_()
 	, current_planner_(new GroundUpPathPlanner(ground_up_tile_map_))
 {
@@ -1423,6 +1434,13 @@ PathPlannerLab::~PathPlannerLab()
 	CloseHandle(thread_handle_);
 	thread_handle_ = 0;
 	thread_id_ = 0;
+
+	// A benchmark still running touches nothing here and ends with the process.
+	if (benchmark_thread_handle_ != 0)
+	{
+		CloseHandle(benchmark_thread_handle_);
+		benchmark_thread_handle_ = 0;
+	}
 	current_planner_->shutdownSearch();
 	delete current_planner_;
 }
@@ -2388,6 +2406,22 @@ void PathPlannerLab::timeRunByKey_()
 	}
 }
 
+void PathPlannerLab::benchmarkByKey_()
+{
+	// The sweep takes minutes, so it runs on its own thread, one at a time.
+	if (benchmark_thread_handle_ != 0)
+	{
+		if (WaitForSingleObject(benchmark_thread_handle_, 0) == WAIT_TIMEOUT)
+		{
+			return;
+		}
+
+		CloseHandle(benchmark_thread_handle_);
+	}
+
+	benchmark_thread_handle_ = CreateThread(0, 0, benchmarkThread, 0, 0, 0);
+}
+
 bool PathPlannerLab::onKeyPress(WPARAM w_param)
 {
 	if (tile_map_width_ && tile_map_height_)
@@ -2429,6 +2463,12 @@ bool PathPlannerLab::onKeyPress(WPARAM w_param)
 				onSetGoal();
 				return true;
 			}
+
+			case 0x42:  // 'B'
+			{
+				benchmarkByKey_();
+				return true;
+			}
 		}
 	}
 
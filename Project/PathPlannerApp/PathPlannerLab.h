@@ -355,6 +355,7 @@ class PathPlannerLab
 	Synchronizer           thread_sync_;
 	DWORD                  thread_id_;
 	HANDLE                 thread_handle_;
+	HANDLE                 benchmark_thread_handle_;
 
 	// path-planning components
 	fullsail_ai::TileMap   ground_up_tile_map_;
@@ -449,6 +450,7 @@ private:
 	void runByKey_();
 	void stepByKey_();
 	void timeRunByKey_();
+	void benchmarkByKey_();
 
 	// Helper methods for rendering the path planner.
 	void renderFull_();
@@ -6,7 +6,60 @@
 #include <istream>
 #include "../TileSystem/TileMap.h"
 
-//! \brief Loads a tile map from the specified input stream.
+//! \brief Loads the optional attribute channels that may follow the weights of a tile map.
+//!
+//! The section starts with the keyword <code>channels</code> and the number of channels,
+//! followed by one grid per channel laid out like the weights:
+//! <pre>
+//! channels 2
+//! 0 0 1 ...   (channel 0, row by row)
+//! ...
+//! 3 3 7 ...   (channel 1, row by row)
+//! </pre>
+//! Files without the section load as before, and whatever follows the weights is left in
+//! the stream for the planner to read.
+template <typename CharT, typename CharTraits>
+bool loadChannels(std::basic_istream<CharT,CharTraits>& input_stream,
+	fullsail_ai::TileMap& tile_map)
+{
+	char const keyword[] = "channels";
+
+	input_stream >> std::ws;
+	if (input_stream.eof()
+		|| input_stream.peek() != CharTraits::to_int_type(input_stream.widen('c')))
+		return true;
+
+	for (int i = 0; keyword[i]; ++i)
+	{
+		if (input_stream.get() != CharTraits::to_int_type(input_stream.widen(keyword[i])))
+			return false;
+	}
+
+	int channel_count = 0;
+	if (!(input_stream >> channel_count) || channel_count < 0)
+		return false;
+
+	tile_map.createChannels(channel_count);
+
+	unsigned int data;
+	for (int channel = 0; channel < channel_count; ++channel)
+	{
+		for (int row = 0; row < tile_map.getRowCount(); ++row)
+		{
+			for (int column = 0; column < tile_map.getColumnCount(); ++column)
+			{
+				if (!(input_stream >> data))
+					return false;
+
+				tile_map.setAttribute(row, column, channel, static_cast<unsigned char>(data));
+			}
+		}
+	}
+
+	return true;
+}
+
+//! \brief Loads a tile map, and any attribute channels, from the specified input stream.
 template <typename CharT, typename CharTraits>
 bool load(std::basic_istream<CharT,CharTraits>& input_stream, fullsail_ai::TileMap& tile_map)
 {
@@ -40,6 +93,12 @@ bool load(std::basic_istream<CharT,CharTraits>& input_stream, fullsail_ai::TileM
 			}
 		}
 
+		if (!loadChannels(input_stream, tile_map))
+		{
+			tile_map.reset();
+			return false;
+		}
+
 		tile_map.computeWeightSumSquared();
 		return true;
 	}
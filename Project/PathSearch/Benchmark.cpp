@@ -0,0 +1,1079 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include "Benchmark.h"
+#include "BitFloodFill.h"
+#include "ContractionHierarchy.h"
+#include "DeltaStepping.h"
+#include "DistanceMatrix.h"
+#include "EarlyCommitSearch.h"
+#include "HashDistributedSearch.h"
+#include "Landmarks.h"
+#include "Parallel.h"
+#include "PathSearch.h"
+#include "RealTimeSearch.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		double MillisecondsSince(Clock::time_point begin)
+		{
+			return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+		}
+
+		// Best time of the repeats
+		template <class Body>
+		double BestMilliseconds(int repeatCount, Body body)
+		{
+			double best = 0.0;
+			for (int r = 0; r < repeatCount; ++r)
+			{
+				Clock::time_point begin = Clock::now();
+				body();
+				double elapsed = MillisecondsSince(begin);
+				best = r == 0 || elapsed < best ? elapsed : best;
+			}
+
+			return best;
+		}
+
+		// Cost of the path a finished search found, whose start tile is last and free
+		unsigned int SolutionCost(PathSearch const& search, std::vector<Tile const*>& path)
+		{
+			path.clear();
+			search.copySolution(std::back_inserter(path));
+
+			unsigned int cost = 0;
+			for (size_t i = 0; i + 1 < path.size(); ++i)
+				cost += path[i]->getWeight();
+			return cost;
+		}
+
+		// What one PathSearch query found, and how long it took
+		struct SearchRun
+		{
+			double milliseconds;
+			// HexGraph::INFINITE_COST if the search found no path
+			unsigned int cost;
+			PathSearch::Status status;
+			int nodeCount;
+		};
+
+		// Runs a (start, goal) query to the end, then exits the search.  The benchmarks turn
+		// drawing off, so the time leaves out repainting the map, which the other searches skip.
+		SearchRun TimePathSearch(PathSearch& search, HexGraph const& graph,
+			std::pair<int, int> const& query, std::vector<Tile const*>& path)
+		{
+			SearchRun run;
+			Clock::time_point begin = Clock::now();
+			search.enter(graph.getRow(query.first), graph.getColumn(query.first),
+				graph.getRow(query.second), graph.getColumn(query.second));
+			search.update(0x7FFFFFFF);
+			run.milliseconds = MillisecondsSince(begin);
+
+			run.cost = search.hasSolution() ? SolutionCost(search, path) : HexGraph::INFINITE_COST;
+			run.status = search.getStatus();
+			run.nodeCount = search.getNodeCount();
+			search.exit();
+			return run;
+		}
+
+		// Radius that lets SampleTile() draw from the whole map
+		int const ANYWHERE = -1;
+
+		// Passable tile within the radius, in rows and columns, of another tile; -1 if the
+		// draw falls off the map or on a wall
+		int SampleTile(HexGraph const& graph, int around, int radius, std::mt19937& random)
+		{
+			int tile;
+			if (radius < 0)
+			{
+				tile = static_cast<int>(random() % graph.getTileCount());
+			}
+			else
+			{
+				int row = graph.getRow(around) + static_cast<int>(random() % (2 * radius + 1))
+					- radius;
+				int column = graph.getColumn(around)
+					+ static_cast<int>(random() % (2 * radius + 1)) - radius;
+				if (row < 0 || column < 0 || row >= graph.getRowCount()
+					|| column >= graph.getColumnCount())
+					return -1;
+
+				tile = graph.toIndex(row, column);
+			}
+
+			return graph.isPassable(tile) ? tile : -1;
+		}
+
+		// Up to count (start, goal) pairs of different passable tiles that the filter accepts,
+		// each goal drawn from the whole map and its start within the radius; gives up after
+		// a hundred draws per pair
+		template <class Filter>
+		std::vector<std::pair<int, int> > SampleQueries(HexGraph const& graph, int count,
+			int radius, std::mt19937& random, Filter accept)
+		{
+			std::vector<std::pair<int, int> > queries;
+			for (int attempt = 0; static_cast<int>(queries.size()) < count
+				&& attempt < count * 100; ++attempt)
+			{
+				int goal = SampleTile(graph, 0, ANYWHERE, random);
+				int start = goal < 0 ? -1 : SampleTile(graph, goal, radius, random);
+				if (start >= 0 && start != goal && accept(start, goal))
+					queries.push_back(std::make_pair(start, goal));
+			}
+
+			return queries;
+		}
+
+		std::vector<std::pair<int, int> > SampleQueries(HexGraph const& graph, int count,
+			int radius, std::mt19937& random)
+		{
+			return SampleQueries(graph, count, radius, random, [](int, int) { return true; });
+		}
+
+		// Value below which the fraction of the sorted samples lies
+		double Percentile(std::vector<double> const& sorted, double fraction)
+		{
+			size_t rank = static_cast<size_t>(fraction * sorted.size());
+			return sorted[rank < sorted.size() ? rank : sorted.size() - 1];
+		}
+
+		// Moves from the source to every tile, one tile at a time
+		void QueueHops(HexGraph const& graph, int source, std::vector<int>& hops,
+			std::vector<int>& queue)
+		{
+			hops.assign(graph.getTileCount(), -1);
+			queue.clear();
+			hops[source] = 0;
+			queue.push_back(source);
+
+			for (int i = 0; i < static_cast<int>(queue.size()); ++i)
+			{
+				for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+				{
+					int neighbor = graph.getNeighbor(queue[i], d);
+					if (neighbor >= 0 && hops[neighbor] < 0)
+					{
+						hops[neighbor] = hops[queue[i]] + 1;
+						queue.push_back(neighbor);
+					}
+				}
+			}
+		}
+
+		// Powers of two up to the limit, and the limit itself
+		std::vector<unsigned int> ThreadCountsUpTo(unsigned int maxThreads)
+		{
+			std::vector<unsigned int> threadCounts;
+			for (unsigned int t = 1; t < maxThreads; t *= 2)
+				threadCounts.push_back(t);
+			threadCounts.push_back(maxThreads);
+			return threadCounts;
+		}
+	}
+
+	void generateMap(TileMap& tileMap, int rowCount, int columnCount, unsigned int seed,
+		int wallPercent)
+	{
+		std::mt19937 random(seed);
+
+		tileMap.createTileArray(rowCount, columnCount);
+		for (int row = 0; row < rowCount; ++row)
+		{
+			for (int column = 0; column < columnCount; ++column)
+			{
+				bool wall = static_cast<int>(random() % 100) < wallPercent;
+				tileMap.addTile(row, column, wall ? 0 : static_cast<unsigned char>(1 + random() % 9));
+			}
+		}
+
+		tileMap.computeWeightSumSquared();
+		tileMap.setRadius(1.0);
+	}
+
+	void benchmarkDeltaStepping(std::ostream& out, HexGraph const& graph,
+		std::vector<unsigned int> const& deltas, std::vector<unsigned int> const& threadCounts,
+		int repeatCount)
+	{
+		int source = graph.toIndex(graph.getRowCount() / 2, graph.getColumnCount() / 2);
+		std::vector<unsigned int> expected;
+		std::vector<unsigned int> costs;
+
+		double sequential = BestMilliseconds(repeatCount, [&]()
+		{
+			graph.computeCosts(source, expected);
+		});
+
+		out << "  Dijkstra: " << std::fixed << std::setprecision(2) << sequential << " ms\n";
+		out << "   delta threads          ms  speedup  buckets  light phases  relaxations\n";
+
+		for (int d = 0; d < static_cast<int>(deltas.size()); ++d)
+		{
+			for (int t = 0; t < static_cast<int>(threadCounts.size()); ++t)
+			{
+				DeltaStepping search;
+				search.setDelta(deltas[d]);
+
+				double best = BestMilliseconds(repeatCount, [&]()
+				{
+					search.computeCosts(graph, source, costs, false, HexGraph::INFINITE_COST,
+						threadCounts[t]);
+				});
+
+				out << std::setw(8) << search.getDelta() << std::setw(8) << threadCounts[t]
+					<< std::setw(12) << best << std::setw(9) << sequential / best
+					<< std::setw(9) << search.getBucketCount()
+					<< std::setw(14) << search.getLightPhaseCount()
+					<< std::setw(13) << search.getRelaxationCount();
+				if (costs != expected)
+					out << "  MISMATCH";
+				out << '\n';
+			}
+		}
+	}
+
+	void benchmarkDistanceMatrix(std::ostream& out, TileMap* tileMap,
+		std::vector<unsigned int> const& threadCounts, int pointCount)
+	{
+		static int const RADIUS = 128;
+		static int const SAMPLED_ROWS = 4;
+
+		PathSearch search;
+		search.setDrawing(false);
+		search.setHeuristic(PathSearch::LANDMARK_HEURISTIC);
+		search.initialize(tileMap);
+		HexGraph const& graph = search.getGraph();
+		std::mt19937 random(1);
+
+		int const middle = graph.toIndex(graph.getRowCount() / 2, graph.getColumnCount() / 2);
+		std::vector<int> points;
+		for (int attempt = 0; static_cast<int>(points.size()) < pointCount
+			&& attempt < pointCount * 100; ++attempt)
+		{
+			int tile = SampleTile(graph, middle, RADIUS, random);
+			if (tile >= 0)
+				points.push_back(tile);
+		}
+
+		if (points.empty())
+		{
+			out << "  No passable tiles\n";
+			search.shutdown();
+			return;
+		}
+
+		int const count = static_cast<int>(points.size());
+		int const sampledRows = count < SAMPLED_ROWS ? count : SAMPLED_ROWS;
+		std::vector<unsigned int> sampled(sampledRows * count);
+		std::vector<Tile const*> path;
+
+		double searchTotal = 0.0;
+		for (int row = 0; row < sampledRows; ++row)
+		{
+			for (int column = 0; column < count; ++column)
+			{
+				SearchRun run =
+					TimePathSearch(search, graph, std::make_pair(points[row], points[column]), path);
+				sampled[row * count + column] = run.cost;
+				searchTotal += run.milliseconds;
+			}
+		}
+		double const pointToPoint = searchTotal * count / sampledRows;
+
+		out << std::fixed << std::setprecision(2);
+		out << "  " << count << " points; PathSearch for every pair: " << pointToPoint
+			<< " ms, scaled from " << sampledRows * count << " pairs\n";
+		out << "  threads          ms  speedup  settled tiles   path KB\n";
+
+		for (int t = 0; t < static_cast<int>(threadCounts.size()); ++t)
+		{
+			DistanceMatrix matrix;
+			Clock::time_point begin = Clock::now();
+			matrix.compute(graph, points, points, true, threadCounts[t]);
+			double elapsed = MillisecondsSince(begin);
+
+			bool mismatch = false;
+			for (int i = 0; i < sampledRows * count; ++i)
+				mismatch |= matrix.getCosts()[i] != sampled[i];
+
+			out << std::setw(9) << threadCounts[t] << std::setw(12) << elapsed
+				<< std::setw(9) << pointToPoint / elapsed
+				<< std::setw(15) << matrix.getSettledCount()
+				<< std::setw(10) << matrix.getPathMemoryUsage() / 1024.0;
+			if (mismatch)
+				out << "  MISMATCH";
+			out << '\n';
+		}
+
+		search.shutdown();
+	}
+
+	void benchmarkHashDistributed(std::ostream& out, TileMap* tileMap,
+		std::vector<unsigned int> const& threadCounts, int queryCount)
+	{
+		PathSearch search;
+		search.setDrawing(false);
+		search.setHeuristic(PathSearch::LANDMARK_HEURISTIC);
+		search.initialize(tileMap);
+		HexGraph const& graph = search.getGraph();
+		LandmarkTable landmarks;
+		landmarks.build(graph, 16);
+		std::mt19937 random(1);
+
+		// Tiles at least half the map apart and joined by a path, with the optimal cost of each
+		int const farApart = graph.getRowCount() / 2;
+		std::vector<unsigned int> optimal;
+		std::vector<unsigned int> costs;
+		std::vector<std::pair<int, int> > queries =
+			SampleQueries(graph, queryCount, ANYWHERE, random, [&](int start, int goal)
+		{
+			if (graph.getHexDistance(start, goal) < farApart)
+				return false;
+
+			graph.computeCosts(start, costs);
+			if (costs[goal] == HexGraph::INFINITE_COST)
+				return false;
+
+			optimal.push_back(costs[goal]);
+			return true;
+		});
+
+		if (queries.empty())
+		{
+			out << "  No connected tiles\n";
+			search.shutdown();
+			return;
+		}
+
+		std::vector<Tile const*> path;
+		bool suboptimal = false;
+		double searchTotal = 0.0;
+		for (size_t q = 0; q < queries.size(); ++q)
+		{
+			SearchRun run = TimePathSearch(search, graph, queries[q], path);
+			suboptimal |= run.cost != optimal[q];
+			searchTotal += run.milliseconds;
+		}
+		double const sequential = searchTotal / queries.size();
+
+		out << std::fixed << std::setprecision(2);
+		out << "  " << queries.size() << " queries, landmarks; PathSearch: " << sequential
+			<< " ms per query" << (suboptimal ? "  NOT OPTIMAL" : "") << '\n';
+		out << "  threads    ms per query  speedup   expanded   messages\n";
+
+		for (int t = 0; t < static_cast<int>(threadCounts.size()); ++t)
+		{
+			HashDistributedSearch parallel;
+			unsigned long long expanded = 0;
+			unsigned long long messages = 0;
+			double total = 0.0;
+			suboptimal = false;
+
+			for (size_t q = 0; q < queries.size(); ++q)
+			{
+				Clock::time_point begin = Clock::now();
+				unsigned int cost = parallel.findPath(graph, queries[q].first, queries[q].second,
+					path, threadCounts[t], &landmarks);
+				total += MillisecondsSince(begin);
+
+				suboptimal |= cost != optimal[q];
+				expanded += parallel.getExpandedCount();
+				for (unsigned int w = 0; w < parallel.getWorkerCount(); ++w)
+					messages += parallel.getWorkerStats(w).sentCount;
+			}
+
+			out << std::setw(9) << threadCounts[t] << std::setw(16) << total / queries.size()
+				<< std::setw(9) << sequential * queries.size() / total
+				<< std::setw(11) << expanded / queries.size()
+				<< std::setw(11) << messages / queries.size();
+			if (suboptimal)
+				out << "  NOT OPTIMAL";
+			out << '\n';
+		}
+
+		search.shutdown();
+	}
+
+	void benchmarkContractionHierarchy(std::ostream& out, TileMap* tileMap,
+		std::vector<unsigned int> const& threadCounts, int queryCount)
+	{
+		static int const SAMPLED_QUERIES = 20;
+
+		PathSearch search;
+		search.setDrawing(false);
+		search.setHeuristic(PathSearch::LANDMARK_HEURISTIC);
+		search.initialize(tileMap);
+		HexGraph const& graph = search.getGraph();
+		std::mt19937 random(1);
+
+		std::vector<std::pair<int, int> > queries =
+			SampleQueries(graph, queryCount, ANYWHERE, random);
+
+		if (queries.empty())
+		{
+			out << "  No passable tiles\n";
+			search.shutdown();
+			return;
+		}
+
+		out << std::fixed << std::setprecision(2);
+		out << "  threads    build ms  speedup  shortcuts\n";
+
+		ContractionHierarchy hierarchy;
+		double firstBuild = 0.0;
+		for (int t = 0; t < static_cast<int>(threadCounts.size()); ++t)
+		{
+			Clock::time_point begin = Clock::now();
+			hierarchy.build(graph, threadCounts[t]);
+			double elapsed = MillisecondsSince(begin);
+			firstBuild = t == 0 ? elapsed : firstBuild;
+
+			out << std::setw(9) << threadCounts[t] << std::setw(12) << elapsed
+				<< std::setw(9) << firstBuild / elapsed
+				<< std::setw(11) << hierarchy.getShortcutCount() << '\n';
+		}
+
+		int const count = static_cast<int>(queries.size());
+		std::vector<unsigned int> costs(count);
+		std::vector<double> microseconds(count);
+		ContractionHierarchy::Query query;
+		unsigned long long settled = 0;
+
+		// Warm the query scratch up, as a game would before its first frame
+		hierarchy.findCost(queries[0].first, queries[0].second, query);
+
+		for (int q = 0; q < count; ++q)
+		{
+			Clock::time_point begin = Clock::now();
+			costs[q] = hierarchy.findCost(queries[q].first, queries[q].second, query);
+			microseconds[q] = MillisecondsSince(begin) * 1000.0;
+			settled += query.getSettledCount();
+		}
+
+		std::vector<Tile const*> path;
+		Clock::time_point begin = Clock::now();
+		for (int q = 0; q < count; ++q)
+			hierarchy.findPath(graph, queries[q].first, queries[q].second, path, query);
+		double const pathMicroseconds = MillisecondsSince(begin) * 1000.0 / count;
+
+		int const sampled = count < SAMPLED_QUERIES ? count : SAMPLED_QUERIES;
+		bool mismatch = false;
+		double searchTotal = 0.0;
+		for (int q = 0; q < sampled; ++q)
+		{
+			SearchRun run = TimePathSearch(search, graph, queries[q], path);
+			mismatch |= run.cost != costs[q];
+			searchTotal += run.milliseconds;
+		}
+		double const searchMicroseconds = searchTotal * 1000.0 / sampled;
+
+		double total = 0.0;
+		for (int q = 0; q < count; ++q)
+			total += microseconds[q];
+		std::sort(microseconds.begin(), microseconds.end());
+
+		out << "  " << count << " queries; cost us mean " << total / count
+			<< ", 99% " << Percentile(microseconds, 0.99)
+			<< ", worst " << microseconds.back()
+			<< "; path us mean " << pathMicroseconds
+			<< "; settled " << settled / count << '\n';
+		out << "  PathSearch: " << searchMicroseconds << " us per query over " << sampled
+			<< " queries, " << searchMicroseconds * count / total << "x the hierarchy";
+		if (mismatch)
+			out << "  MISMATCH";
+		out << '\n';
+
+		search.shutdown();
+	}
+
+	void benchmarkFloodFill(std::ostream& out, TileMap* tileMap, int repeatCount)
+	{
+		static int const RANGE = 10;
+		static char const* const OPERATIONS[] =
+		{
+			"reachable tiles", "moves to every tile", "tiles within 10 moves", "components"
+		};
+
+		PathSearch search;
+		search.setDrawing(false);
+		search.initialize(tileMap);
+		HexGraph const& graph = search.getGraph();
+		HexBitboard passable;
+		passable.build(graph);
+
+		int source = graph.toIndex(graph.getRowCount() / 2, graph.getColumnCount() / 2);
+		while (source < graph.getTileCount() && !graph.isPassable(source))
+			++source;
+		if (source == graph.getTileCount())
+		{
+			out << "  No passable tile\n";
+			search.shutdown();
+			return;
+		}
+
+		std::vector<int> expected;
+		std::vector<int> hops;
+		std::vector<int> queue;
+		double sequential = BestMilliseconds(repeatCount, [&]()
+		{
+			QueueHops(graph, source, expected, queue);
+		});
+
+		int farthest = source;
+		for (int i = 0; i < graph.getTileCount(); ++i)
+			farthest = expected[i] > expected[farthest] ? i : farthest;
+
+		std::vector<Tile const*> path;
+		double pathSearch = BestMilliseconds(repeatCount, [&]()
+		{
+			TimePathSearch(search, graph, std::make_pair(source, farthest), path);
+		});
+
+		out << std::fixed << std::setprecision(3);
+		out << "  PathSearch to the farthest tile, " << expected[farthest] << " moves away: "
+			<< pathSearch << " ms\n";
+		out << "  Tile-at-a-time search, moves to every tile: " << sequential << " ms\n";
+		out << "  operation                 portable ms     AVX2 ms  speedup\n";
+
+		for (int operation = 0; operation < 4; ++operation)
+		{
+			double times[2] = { 0.0, 0.0 };
+			bool matches = true;
+			int componentCount = 0;
+
+			for (int kernel = 0; kernel < 2; ++kernel)
+			{
+				BitFloodFill fill;
+				fill.setUseAvx2(kernel == 1);
+				if (kernel == 1 && !fill.isUsingAvx2())
+					continue;
+
+				times[kernel] = BestMilliseconds(repeatCount, [&]()
+				{
+					switch (operation)
+					{
+					case 0: fill.fill(passable, source); break;
+					case 1: fill.computeHops(passable, source, hops); break;
+					case 2: fill.fillWithin(passable, source, RANGE); break;
+					default: componentCount = fill.labelComponents(passable, hops); break;
+					}
+				});
+
+				if (operation == 1)
+					matches = matches && hops == expected;
+				else if (operation != 3)
+				{
+					int limit = operation == 2 ? RANGE : 0x7FFFFFFF;
+					for (int i = 0; i < graph.getTileCount(); ++i)
+						matches = matches
+							&& fill.isReached(i) == (expected[i] >= 0 && expected[i] <= limit);
+				}
+			}
+
+			double fastest = times[1] > 0.0 && times[1] < times[0] ? times[1] : times[0];
+			out << "  " << std::left << std::setw(24) << OPERATIONS[operation] << std::right
+				<< std::setw(13) << times[0];
+			if (times[1] > 0.0)
+				out << std::setw(12) << times[1];
+			else
+				out << std::setw(12) << "n/a";
+
+			// The tile-at-a-time search does the work of the first two operations
+			if (operation < 2)
+				out << std::setw(8) << std::setprecision(1) << sequential / fastest << 'x'
+					<< std::setprecision(3);
+			else if (operation == 3)
+				out << "  (" << componentCount << " components)";
+			if (!matches)
+				out << "  MISMATCH";
+			out << '\n';
+		}
+
+		search.shutdown();
+	}
+
+	void benchmarkRealTimeSearch(std::ostream& out, TileMap* tileMap, int queryCount)
+	{
+		static int const LOOKAHEADS[] = { 1, 8, 32, 128 };
+		static int const RADIUS = 64;
+		static int const TRIP_COUNT = 5;
+
+		PathSearch search;
+		search.setDrawing(false);
+		search.initialize(tileMap);
+		HexGraph const& graph = search.getGraph();
+		std::mt19937 random(1);
+
+		std::vector<unsigned int> optimal;
+		std::vector<Tile const*> path;
+		double aStarTotal = 0.0;
+		double aStarWorst = 0.0;
+
+		// Pairs joined by a path, with the optimal cost of each and the time A* took
+		std::vector<std::pair<int, int> > queries =
+			SampleQueries(graph, queryCount, RADIUS, random, [&](int start, int goal)
+		{
+			SearchRun run = TimePathSearch(search, graph, std::make_pair(start, goal), path);
+			if (run.cost == HexGraph::INFINITE_COST)
+				return false;
+
+			optimal.push_back(run.cost);
+			aStarTotal += run.milliseconds;
+			aStarWorst = (std::max)(aStarWorst, run.milliseconds);
+			return true;
+		});
+
+		if (queries.empty())
+		{
+			out << "  No connected pair of tiles\n";
+			search.shutdown();
+			return;
+		}
+
+		unsigned long long optimalTotal = 0;
+		for (size_t q = 0; q < optimal.size(); ++q)
+			optimalTotal += optimal[q];
+
+		LandmarkTable landmarks;
+		landmarks.build(graph, 16);
+
+		// The first tiles of the first two regions, which agents must turn down at once
+		std::pair<int, int> unconnected(ANYWHERE, ANYWHERE);
+		{
+			HexBitboard passable;
+			passable.build(graph);
+			std::vector<int> regions;
+			if (BitFloodFill().labelComponents(passable, regions) > 1)
+			{
+				unconnected.first = static_cast<int>(
+					std::find(regions.begin(), regions.end(), 0) - regions.begin());
+				unconnected.second = static_cast<int>(
+					std::find(regions.begin(), regions.end(), 1) - regions.begin());
+			}
+		}
+
+		out << std::fixed << std::setprecision(3);
+		out << "  A* (PathSearch), whole path: mean " << aStarTotal / queries.size()
+			<< " ms, worst " << aStarWorst << " ms over " << queries.size() << " queries\n";
+		out << "  heuristic  lookahead  us/move    99.9%    worst  1st trip cost  5th trip cost"
+			"  learned KB  no path us\n";
+
+		std::vector<double> moveTimes;
+		for (int h = 0; h < 2; ++h)
+		{
+			for (int l = 0; l < static_cast<int>(sizeof(LOOKAHEADS) / sizeof(LOOKAHEADS[0])); ++l)
+			{
+				RealTimeSearch agent;
+				agent.initialize(graph, h == 1 ? &landmarks : 0);
+				agent.setLookahead(LOOKAHEADS[l]);
+
+				unsigned long long tripCosts[TRIP_COUNT] = {};
+				double moveTotal = 0.0;
+				bool stuck = false;
+				moveTimes.clear();
+
+				// The goal of an unconnected pair must be turned down before any learning
+				double refusal = -1.0;
+				if (unconnected.first != ANYWHERE)
+				{
+					Clock::time_point begin = Clock::now();
+					if (agent.step(unconnected.first, unconnected.second) < 0)
+						refusal = MillisecondsSince(begin) * 1000.0;
+					else
+						stuck = true;
+				}
+
+				for (int trip = 0; trip < TRIP_COUNT; ++trip)
+				{
+					for (size_t q = 0; q < queries.size(); ++q)
+					{
+						// Agents that wander far longer than the optimal path are given up on
+						long long const moveLimit = 100LL * optimal[q] + 1000;
+						int tile = queries[q].first;
+
+						for (long long moves = 0; tile != queries[q].second; ++moves)
+						{
+							Clock::time_point begin = Clock::now();
+							int next = agent.step(tile, queries[q].second);
+							double elapsed = MillisecondsSince(begin) * 1000.0;
+
+							moveTotal += elapsed;
+							moveTimes.push_back(elapsed);
+
+							if (next < 0 || moves == moveLimit)
+							{
+								stuck = true;
+								break;
+							}
+
+							tripCosts[trip] += graph.getWeight(next);
+							tile = next;
+						}
+					}
+				}
+
+				std::sort(moveTimes.begin(), moveTimes.end());
+				out << std::setprecision(1) << (h == 1 ? "  landmarks" : "  hex dist.")
+					<< std::setw(11) << LOOKAHEADS[l]
+					<< std::setw(9) << moveTotal / moveTimes.size()
+					<< std::setw(9) << moveTimes[moveTimes.size() * 999 / 1000]
+					<< std::setw(9) << moveTimes.back() << std::setprecision(2)
+					<< std::setw(14) << static_cast<double>(tripCosts[0]) / optimalTotal << 'x'
+					<< std::setw(14)
+					<< static_cast<double>(tripCosts[TRIP_COUNT - 1]) / optimalTotal << 'x'
+					<< std::setw(12) << std::setprecision(0) << agent.getMemoryUsage() / 1024.0
+					<< std::setprecision(1);
+				if (refusal < 0.0)
+					out << std::setw(12) << '-';
+				else
+					out << std::setw(12) << refusal;
+				out << std::setprecision(3);
+				if (stuck)
+					out << "  STUCK";
+				out << '\n';
+			}
+		}
+
+		search.shutdown();
+	}
+
+	void benchmarkAdaptiveSearch(std::ostream& out, TileMap* tileMap, int goalCount,
+		int queriesPerGoal)
+	{
+		static int const RADIUS = 64;
+
+		PathSearch search;
+		search.setDrawing(false);
+		search.initialize(tileMap);
+		HexGraph const& graph = search.getGraph();
+		std::mt19937 random(1);
+
+		std::vector<int> goals;
+		for (int attempt = 0; static_cast<int>(goals.size()) < goalCount
+			&& attempt < goalCount * 100; ++attempt)
+		{
+			int goal = SampleTile(graph, 0, ANYWHERE, random);
+			if (goal >= 0)
+				goals.push_back(goal);
+		}
+
+		// Starts around each goal, taking turns between the goals as units of a game would
+		std::vector<std::pair<int, int> > queries;
+		for (int q = 0; q < goalCount * queriesPerGoal && !goals.empty(); ++q)
+		{
+			int goal = goals[q % goals.size()];
+			for (int attempt = 0; attempt < 100; ++attempt)
+			{
+				int start = SampleTile(graph, goal, RADIUS, random);
+				if (start >= 0 && start != goal)
+				{
+					queries.push_back(std::make_pair(start, goal));
+					break;
+				}
+			}
+		}
+
+		if (queries.empty())
+		{
+			out << "  No passable tiles\n";
+			search.shutdown();
+			return;
+		}
+
+		out << std::fixed << std::setprecision(3);
+		out << "  " << goals.size() << " goals, " << queries.size() << " queries; ms per query,"
+			" and path cost against plain A*\n";
+		out << "  heuristic  search    all queries  last quarter  path cost  learned KB\n";
+
+		std::vector<Tile const*> path;
+		std::vector<unsigned int> plainCosts(queries.size());
+		for (int h = 0; h < 2; ++h)
+		{
+			search.setHeuristic(h == 1 ? PathSearch::LANDMARK_HEURISTIC
+				: PathSearch::HEX_DISTANCE_HEURISTIC);
+			search.initialize(tileMap);
+
+			for (int adaptive = 0; adaptive < 2; ++adaptive)
+			{
+				search.setAdaptive(adaptive == 1 ? goalCount : 0);
+
+				size_t const lastQuarter = queries.size() - queries.size() / 4;
+				double total = 0.0;
+				double lastQuarterTotal = 0.0;
+				unsigned long long plainCostTotal = 0;
+				unsigned long long costTotal = 0;
+
+				for (size_t q = 0; q < queries.size(); ++q)
+				{
+					SearchRun run = TimePathSearch(search, graph, queries[q], path);
+					unsigned int cost = run.cost != HexGraph::INFINITE_COST ? run.cost : 0;
+
+					if (adaptive == 0)
+						plainCosts[q] = cost;
+					plainCostTotal += plainCosts[q];
+					costTotal += cost;
+					total += run.milliseconds;
+					if (q >= lastQuarter)
+						lastQuarterTotal += run.milliseconds;
+				}
+
+				out << (h == 1 ? "  landmarks" : "  hex dist.") << (adaptive == 1 ? "  adaptive"
+					: "  plain   ") << std::setw(15) << total / queries.size()
+					<< std::setw(14) << lastQuarterTotal / (queries.size() - lastQuarter)
+					<< std::setw(10) << std::setprecision(4)
+					<< (plainCostTotal == 0 ? 1.0 : static_cast<double>(costTotal) / plainCostTotal)
+					<< 'x' << std::setw(12) << std::setprecision(0)
+					<< search.getLearnedMemoryUsage() / 1024.0 << std::setprecision(3) << '\n';
+			}
+		}
+
+		search.shutdown();
+	}
+
+	void benchmarkFirstMove(std::ostream& out, TileMap* tileMap, int queryCount,
+		unsigned int frameBudget)
+	{
+		static double const WEIGHTS[] = { 1.5, 2, 4 };
+		static int const RADIUS = 128;
+
+		HexGraph graph;
+		graph.build(tileMap);
+		LandmarkTable landmarks;
+		landmarks.build(graph, 16);
+		std::mt19937 random(1);
+
+		std::vector<unsigned int> optimal;
+		std::vector<std::pair<int, int> > queries =
+			SampleQueries(graph, queryCount, RADIUS, random, [&](int start, int goal)
+		{
+			SearchSession session = SearchSession::create(graph, start, goal, &landmarks);
+			while (!session.resume(0x7FFFFFFF))
+			{
+			}
+
+			if (!session.isFound())
+				return false;
+
+			optimal.push_back(session.getCost());
+			return true;
+		});
+
+		if (queries.empty())
+		{
+			out << "  No connected pair of tiles\n";
+			return;
+		}
+
+		unsigned long long optimalTotal = 0;
+		for (size_t q = 0; q < optimal.size(); ++q)
+			optimalTotal += optimal[q];
+
+		out << std::fixed << std::setprecision(3);
+		out << "  " << queries.size() << " queries, " << frameBudget
+			<< " expansions per frame, landmarks; ms\n";
+		out << "  search      first move: p50     p90     p99     max"
+			"   full path: p50     p90     p99     max  quick cost  final cost\n";
+
+		std::vector<double> firstMoveTimes;
+		std::vector<double> fullTimes;
+		for (int w = -1; w < static_cast<int>(sizeof(WEIGHTS) / sizeof(WEIGHTS[0])); ++w)
+		{
+			EarlyCommitSearch search;
+			if (w >= 0)
+				search.setWeight(WEIGHTS[w]);
+
+			unsigned long long quickTotal = 0;
+			unsigned long long finalTotal = 0;
+			firstMoveTimes.clear();
+			fullTimes.clear();
+
+			for (size_t q = 0; q < queries.size(); ++q)
+			{
+				// Without early commit the agent waits for the whole optimal path
+				double firstMove = 0.0;
+				Clock::time_point begin = Clock::now();
+				if (w < 0)
+				{
+					SearchSession session =
+						SearchSession::create(graph, queries[q].first, queries[q].second,
+							&landmarks);
+					while (!session.resume(frameBudget))
+					{
+					}
+
+					firstMove = MillisecondsSince(begin);
+					quickTotal += session.getCost();
+					finalTotal += session.getCost();
+				}
+				else
+				{
+					search.start(graph, queries[q].first, queries[q].second, &landmarks);
+					while (!search.resume(frameBudget))
+					{
+						if (firstMove == 0.0 && search.hasPrefix())
+							firstMove = MillisecondsSince(begin);
+					}
+
+					if (firstMove == 0.0)
+						firstMove = MillisecondsSince(begin);
+					quickTotal += search.getQuickCost();
+					finalTotal += search.getCost();
+				}
+
+				firstMoveTimes.push_back(firstMove);
+				fullTimes.push_back(MillisecondsSince(begin));
+			}
+
+			std::sort(firstMoveTimes.begin(), firstMoveTimes.end());
+			std::sort(fullTimes.begin(), fullTimes.end());
+			if (w < 0)
+				out << "  optimal A*       ";
+			else
+				out << "  early, w " << std::setprecision(1) << WEIGHTS[w] << std::setprecision(3)
+					<< "    ";
+			out << std::setw(8) << Percentile(firstMoveTimes, 0.5)
+				<< std::setw(8) << Percentile(firstMoveTimes, 0.9)
+				<< std::setw(8) << Percentile(firstMoveTimes, 0.99)
+				<< std::setw(8) << firstMoveTimes.back()
+				<< std::setw(15) << Percentile(fullTimes, 0.5)
+				<< std::setw(8) << Percentile(fullTimes, 0.9)
+				<< std::setw(8) << Percentile(fullTimes, 0.99)
+				<< std::setw(8) << fullTimes.back()
+				<< std::setw(11) << static_cast<double>(quickTotal) / optimalTotal << 'x'
+				<< std::setw(11) << static_cast<double>(finalTotal) / optimalTotal << "x\n";
+		}
+	}
+
+	void benchmarkNodeBudget(std::ostream& out, TileMap* tileMap, int queryCount)
+	{
+		static int const BUDGETS[] = { 0, 65536, 16384, 4096, 1024 };
+		static int const RADIUS = 128;
+
+		PathSearch search;
+		search.setDrawing(false);
+		search.setHeuristic(PathSearch::LANDMARK_HEURISTIC);
+		search.initialize(tileMap);
+		HexGraph const& graph = search.getGraph();
+		std::mt19937 random(1);
+
+		std::vector<std::pair<int, int> > queries =
+			SampleQueries(graph, queryCount, RADIUS, random);
+
+		if (queries.empty())
+		{
+			out << "  No passable tiles\n";
+			search.shutdown();
+			return;
+		}
+
+		out << std::fixed << std::setprecision(3);
+		out << "  " << queries.size() << " queries, landmarks\n";
+		out << "  node budget  found  degraded  no path  failed  peak nodes  mean ms  worst ms"
+			"  degraded cost\n";
+
+		std::vector<Tile const*> path;
+		std::vector<unsigned int> optimal(queries.size(), 0);
+		for (int b = 0; b < static_cast<int>(sizeof(BUDGETS) / sizeof(BUDGETS[0])); ++b)
+		{
+			search.setNodeBudget(BUDGETS[b]);
+
+			int counts[PathSearch::SEARCH_FAILED + 1] = {};
+			int peakNodes = 0;
+			double total = 0.0;
+			double worst = 0.0;
+			unsigned long long degradedCost = 0;
+			unsigned long long degradedOptimal = 0;
+
+			for (size_t q = 0; q < queries.size(); ++q)
+			{
+				SearchRun run = TimePathSearch(search, graph, queries[q], path);
+				if (BUDGETS[b] == 0)
+					optimal[q] = run.cost;
+				else if (run.status == PathSearch::SEARCH_DEGRADED)
+				{
+					degradedCost += run.cost;
+					degradedOptimal += optimal[q];
+				}
+
+				++counts[run.status];
+				peakNodes = (std::max)(peakNodes, run.nodeCount);
+				total += run.milliseconds;
+				worst = (std::max)(worst, run.milliseconds);
+			}
+
+			if (BUDGETS[b] == 0)
+				out << "  unlimited  ";
+			else
+				out << std::setw(11) << BUDGETS[b] << "  ";
+			out << std::setw(5) << counts[PathSearch::SEARCH_FOUND]
+				<< std::setw(10) << counts[PathSearch::SEARCH_DEGRADED]
+				<< std::setw(9) << counts[PathSearch::SEARCH_NO_PATH]
+				<< std::setw(8) << counts[PathSearch::SEARCH_FAILED]
+				<< std::setw(12) << peakNodes
+				<< std::setw(9) << total / queries.size()
+				<< std::setw(10) << worst;
+			if (degradedOptimal != 0)
+				out << std::setw(14) << static_cast<double>(degradedCost) / degradedOptimal << 'x';
+			out << '\n';
+		}
+
+		search.shutdown();
+	}
+
+	void runBenchmarks(std::ostream& out, unsigned int maxThreads)
+	{
+		static int const SIZES[] = { 512, 1024, 2048 };
+
+		if (maxThreads == 0)
+			maxThreads = getDefaultThreadCount();
+		std::vector<unsigned int> threadCounts = ThreadCountsUpTo(maxThreads);
+
+		for (int s = 0; s < static_cast<int>(sizeof(SIZES) / sizeof(SIZES[0])); ++s)
+		{
+			TileMap tileMap;
+			generateMap(tileMap, SIZES[s], SIZES[s], 1);
+			HexGraph graph;
+			graph.build(&tileMap);
+
+			out << "Generated map " << SIZES[s] << 'x' << SIZES[s] << ", 20% walls\n";
+
+			// Around the default width, which is twice the mean weight, and both extremes
+			unsigned int const widest = 255;
+			unsigned int const middle = DeltaStepping::getDefaultDelta(graph);
+			unsigned int candidates[] = { 1, middle / 4, middle / 2, middle, middle * 2, widest };
+			std::vector<unsigned int> deltas;
+			for (int c = 0; c < static_cast<int>(sizeof(candidates) / sizeof(candidates[0])); ++c)
+			{
+				if (candidates[c] != 0
+					&& std::find(deltas.begin(), deltas.end(), candidates[c]) == deltas.end())
+					deltas.push_back(candidates[c]);
+			}
+
+			out << "Delta-stepping distance field from the middle tile\n";
+			benchmarkDeltaStepping(out, graph, deltas, threadCounts);
+			out << "Distance matrix against point-to-point searches, 64 points near the middle\n";
+			benchmarkDistanceMatrix(out, &tileMap, threadCounts);
+			out << "Hash-distributed A* against PathSearch, tiles at least half the map apart\n";
+			benchmarkHashDistributed(out, &tileMap, threadCounts);
+			out << "Contraction hierarchy against PathSearch, random tiles\n";
+			benchmarkContractionHierarchy(out, &tileMap, threadCounts);
+			out << "Bitboard flood fill from the middle tile\n";
+			benchmarkFloodFill(out, &tileMap);
+			out << "Real-time search against A*, tiles up to 64 apart\n";
+			benchmarkRealTimeSearch(out, &tileMap);
+			out << "Adaptive A* against plain A*, starts up to 64 tiles from shared goals\n";
+			benchmarkAdaptiveSearch(out, &tileMap);
+			out << "Time to first move with early commit, tiles up to 128 apart\n";
+			benchmarkFirstMove(out, &tileMap);
+			out << "Node budgets for PathSearch, tiles up to 128 apart\n";
+			benchmarkNodeBudget(out, &tileMap);
+			out << std::endl;
+		}
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,168 @@
+//! \file Benchmark.h
+//! \brief Declares the fullsail_ai::algorithms benchmark functions.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_BENCHMARK_H_
+#define _FULLSAIL_AI_PATH_PLANNER_BENCHMARK_H_
+
+#include <ostream>
+#include <vector>
+#include "HexGraph.h"
+#include "../TileSystem/TileMap.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Fills a tile map with random weights and walls, for benchmarks on maps larger
+	//! than the bundled ones.
+	//!
+	//! The same seed always gives the same map.
+	//!
+	//! \param   tileMap      the map to fill; its previous contents are discarded.
+	//! \param   rowCount     the number of rows.
+	//! \param   columnCount  the number of columns.
+	//! \param   seed         seed of the random generator.
+	//! \param   wallPercent  the chance, in percent, that a tile is a wall.  Other tiles
+	//!                      weigh 1 to 9.
+	DLLEXPORT void generateMap(TileMap& tileMap, int rowCount, int columnCount,
+		unsigned int seed, int wallPercent = 20);
+
+	//! \brief Times <code>DeltaStepping</code> against <code>HexGraph::computeCosts()</code>
+	//! for every pair of bucket width and thread count, and writes one table row per pair.
+	//!
+	//! Each row gives the best time of the repeats, the speedup over the sequential search,
+	//! and the buckets, light phases and relaxations of the run.  Rows whose costs differ from
+	//! the sequential search are flagged.
+	//!
+	//! \param   out           the stream to write the table to.
+	//! \param   graph         the graph to search, from its middle tile.
+	//! \param   deltas        the bucket widths to try; 0 stands for the default width.
+	//! \param   threadCounts  the thread counts to try.
+	//! \param   repeatCount   the number of runs timed per row.
+	DLLEXPORT void benchmarkDeltaStepping(std::ostream& out, HexGraph const& graph,
+		std::vector<unsigned int> const& deltas, std::vector<unsigned int> const& threadCounts,
+		int repeatCount = 3);
+
+	//! \brief Times <code>DistanceMatrix</code> with paths against a
+	//! <code>PathSearch</code> query for every pair of points, and writes one table row per
+	//! thread count.
+	//!
+	//! The points are random passable tiles at most 128 tiles from the middle of the map.
+	//! The point-to-point searches use landmarks; a few rows of them are timed and scaled up
+	//! to the whole matrix.  Each row gives the time to fill the matrix, the speedup over the
+	//! searches, the tiles settled and the memory held by the paths.  Rows whose costs differ
+	//! from the searches are flagged.
+	//!
+	//! \param   out           the stream to write the table to.
+	//! \param   tileMap       the map to search.
+	//! \param   threadCounts  the thread counts to try.
+	//! \param   pointCount    the number of points, each both a source and a target.
+	DLLEXPORT void benchmarkDistanceMatrix(std::ostream& out, TileMap* tileMap,
+		std::vector<unsigned int> const& threadCounts, int pointCount = 64);
+
+	//! \brief Times <code>HashDistributedSearch</code> on long queries against
+	//! single-threaded <code>PathSearch</code>, and writes one table row per thread count.
+	//!
+	//! Each query joins random connected tiles at least half as many moves apart as the map
+	//! has rows.  Both searches use landmarks.  Each row gives the mean time of a query, the
+	//! speedup over <code>PathSearch</code>, and the nodes expanded and messages sent per
+	//! query.  Rows with a path that costs more than Dijkstra's are flagged.
+	//!
+	//! \param   out           the stream to write the table to.
+	//! \param   tileMap       the map to search.
+	//! \param   threadCounts  the thread counts to try.
+	//! \param   queryCount    the number of start and goal pairs.
+	DLLEXPORT void benchmarkHashDistributed(std::ostream& out, TileMap* tileMap,
+		std::vector<unsigned int> const& threadCounts, int queryCount = 5);
+
+	//! \brief Times <code>ContractionHierarchy</code> preprocessing for every thread count,
+	//! then its queries against <code>PathSearch</code>, and writes the results.
+	//!
+	//! Queries join random passable tiles anywhere on the map.  The table gives the time to
+	//! build the hierarchy and the shortcuts added per thread count.  For the queries it
+	//! gives the mean, 99th percentile and worst time of a cost query, the mean time of a
+	//! path query and the labels a query settles.  <code>PathSearch</code> with landmarks
+	//! runs a few of the queries for comparison, and costs that differ from it are flagged.
+	//!
+	//! \param   out           the stream to write the results to.
+	//! \param   tileMap       the map to search.
+	//! \param   threadCounts  the thread counts to build with.
+	//! \param   queryCount    the number of start and goal pairs.
+	DLLEXPORT void benchmarkContractionHierarchy(std::ostream& out, TileMap* tileMap,
+		std::vector<unsigned int> const& threadCounts, int queryCount = 1000);
+
+	//! \brief Times the bitboard flood fill, with the portable and the AVX2 kernel, against
+	//! a breadth-first search that takes one tile at a time and against
+	//! <code>PathSearch</code>, and writes one line per operation.
+	//!
+	//! Searches start from the middle tile, or the nearest passable tile after it.  Results
+	//! that differ from the tile-at-a-time search are flagged.
+	//!
+	//! \param   out          the stream to write the results to.
+	//! \param   tileMap      the map to search.
+	//! \param   repeatCount  the number of runs timed per line.
+	DLLEXPORT void benchmarkFloodFill(std::ostream& out, TileMap* tileMap, int repeatCount = 3);
+
+	//! \brief Times <code>RealTimeSearch</code> moves against whole <code>PathSearch</code>
+	//! queries, and writes one table row per lookahead and initial heuristic.
+	//!
+	//! Queries join random passable tiles at most 64 tiles apart.  Each row gives the mean,
+	//! 99.9th percentile and worst time of one move, and the cost of the first and the fifth
+	//! trip over every query relative to the optimal paths, later trips reusing what earlier
+	//! ones learned.  The last column times one move toward a goal in another connected
+	//! region, which must be turned down at once; it reads - if the map has one region.
+	//!
+	//! \param   out         the stream to write the table to.
+	//! \param   tileMap     the map to search.
+	//! \param   queryCount  the number of start and goal pairs.
+	DLLEXPORT void benchmarkRealTimeSearch(std::ostream& out, TileMap* tileMap,
+		int queryCount = 100);
+
+	//! \brief Times <code>PathSearch</code> queries to a few shared goals with and without
+	//! Adaptive A*, for both heuristics.
+	//!
+	//! Each query starts from a random tile at most 64 tiles from its goal, and the goals
+	//! take turns.  The table gives the mean time over every query and over the last quarter,
+	//! once the goals have learned, and the total path cost relative to plain A*.
+	//!
+	//! \param   out             the stream to write the table to.
+	//! \param   tileMap         the map to search.
+	//! \param   goalCount       the number of goals.
+	//! \param   queriesPerGoal  the number of starts searched for each goal.
+	DLLEXPORT void benchmarkAdaptiveSearch(std::ostream& out, TileMap* tileMap,
+		int goalCount = 8, int queriesPerGoal = 50);
+
+	//! \brief Times how long an agent waits for its first move with
+	//! <code>EarlyCommitSearch</code>, against waiting for a whole optimal path.
+	//!
+	//! Queries join random tiles at most 128 tiles apart and run a frame budget of
+	//! expansions at a time, as a game loop would.  Each row gives percentiles of the time to
+	//! the first move and to the final path, and the cost of the quick and of the stitched
+	//! paths relative to the optimal ones.
+	//!
+	//! \param   out          the stream to write the table to.
+	//! \param   tileMap      the map to search.
+	//! \param   queryCount   the number of start and goal pairs.
+	//! \param   frameBudget  the expansions run between checks for the first move.
+	DLLEXPORT void benchmarkFirstMove(std::ostream& out, TileMap* tileMap,
+		int queryCount = 200, unsigned int frameBudget = 256);
+
+	//! \brief Runs the same <code>PathSearch</code> queries under shrinking node budgets.
+	//!
+	//! Queries join random passable tiles at most 128 tiles apart.  Each row counts how the
+	//! searches ended, gives the most planner nodes any of them held and their times, and
+	//! the cost of the degraded paths relative to the optimal ones.
+	//!
+	//! \param   out         the stream to write the table to.
+	//! \param   tileMap     the map to search.
+	//! \param   queryCount  the number of start and goal pairs.
+	DLLEXPORT void benchmarkNodeBudget(std::ostream& out, TileMap* tileMap,
+		int queryCount = 100);
+
+	//! \brief Runs every benchmark on generated maps of increasing size and writes the
+	//! results.
+	//!
+	//! \param   out          the stream to write the results to.
+	//! \param   maxThreads   the highest thread count tried, or 0 for every hardware thread.
+	DLLEXPORT void runBenchmarks(std::ostream& out, unsigned int maxThreads = 0);
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_BENCHMARK_H_
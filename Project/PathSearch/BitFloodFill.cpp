@@ -0,0 +1,509 @@
+#include <utility>
+#include "BitFloodFill.h"
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <immintrin.h>
+#define FULLSAIL_AI_BITBOARD_AVX2
+#define AVX2_FUNCTION
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#include <immintrin.h>
+#define FULLSAIL_AI_BITBOARD_AVX2
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		typedef unsigned long long Word;
+
+		inline int LowestBit(Word word)
+		{
+#if defined(_MSC_VER)
+			unsigned long index;
+			if (_BitScanForward(&index, static_cast<unsigned long>(word)))
+				return static_cast<int>(index);
+			_BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+			return static_cast<int>(index) + 32;
+#else
+			return __builtin_ctzll(word);
+#endif
+		}
+
+		// Writes the passable, unvisited tiles of one row next to the frontier into the next
+		// level and marks them visited, for <code>count</code> words from the pointers on.  A
+		// tile touches the columns c - 1 and c of the adjacent rows on an even row, c and
+		// c + 1 on an odd one.
+		void ExpandWords(Word const* above, Word const* row, Word const* below,
+			Word const* passable, Word* visited, Word* next, int count, bool odd)
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				Word here = row[i];
+				Word adjacent = here | above[i] | below[i];
+				Word added;
+
+				if (odd)
+				{
+					Word right = row[i + 1] | above[i + 1] | below[i + 1];
+					added = adjacent | (adjacent >> 1) | (right << 63)
+						| (here << 1) | (row[i - 1] >> 63);
+				}
+				else
+				{
+					Word left = row[i - 1] | above[i - 1] | below[i - 1];
+					added = adjacent | (adjacent << 1) | (left >> 63)
+						| (here >> 1) | (row[i + 1] << 63);
+				}
+
+				added &= passable[i] & ~visited[i];
+				visited[i] |= added;
+				next[i] = added;
+			}
+		}
+
+		// Grows the seeds to the whole runs of passable tiles that hold them, first toward
+		// higher columns and then toward lower ones, doubling the reach of each shift
+		void FillRuns(Word const* passable, Word const* seeds, Word* runs, int wordCount)
+		{
+			Word carry = 0;
+			for (int i = 0; i < wordCount; ++i)
+			{
+				Word open = passable[i];
+				Word reached = (seeds[i] | carry) & open;
+				for (int shift = 1; shift < 64; shift <<= 1)
+				{
+					reached |= open & (reached << shift);
+					open &= open << shift;
+				}
+
+				runs[i] = reached;
+				carry = reached >> 63;
+			}
+
+			carry = 0;
+			for (int i = wordCount; i-- > 0; )
+			{
+				Word open = passable[i];
+				Word reached = (runs[i] | carry) & open;
+				for (int shift = 1; shift < 64; shift <<= 1)
+				{
+					reached |= open & (reached >> shift);
+					open &= open >> shift;
+				}
+
+				runs[i] = reached;
+				carry = reached << 63;
+			}
+		}
+
+#if defined(FULLSAIL_AI_BITBOARD_AVX2)
+		AVX2_FUNCTION inline __m256i Load(Word const* words)
+		{
+			return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(words));
+		}
+
+		// ExpandWords four words at a time; <code>count</code> is a multiple of four.  Rows
+		// are padded, so the last group may run past the columns, where the passable mask is
+		// zero.
+		AVX2_FUNCTION void ExpandWordsAvx2(Word const* above, Word const* row, Word const* below,
+			Word const* passable, Word* visited, Word* next, int count, bool odd)
+		{
+			for (int i = 0; i < count; i += 4)
+			{
+				__m256i here = Load(row + i);
+				__m256i adjacent = _mm256_or_si256(here,
+					_mm256_or_si256(Load(above + i), Load(below + i)));
+				__m256i added;
+
+				if (odd)
+				{
+					__m256i right = _mm256_or_si256(Load(row + i + 1),
+						_mm256_or_si256(Load(above + i + 1), Load(below + i + 1)));
+					added = _mm256_or_si256(
+						_mm256_or_si256(adjacent, _mm256_srli_epi64(adjacent, 1)),
+						_mm256_or_si256(_mm256_slli_epi64(right, 63),
+							_mm256_or_si256(_mm256_slli_epi64(here, 1),
+								_mm256_srli_epi64(Load(row + i - 1), 63))));
+				}
+				else
+				{
+					__m256i left = _mm256_or_si256(Load(row + i - 1),
+						_mm256_or_si256(Load(above + i - 1), Load(below + i - 1)));
+					added = _mm256_or_si256(
+						_mm256_or_si256(adjacent, _mm256_slli_epi64(adjacent, 1)),
+						_mm256_or_si256(_mm256_srli_epi64(left, 63),
+							_mm256_or_si256(_mm256_srli_epi64(here, 1),
+								_mm256_slli_epi64(Load(row + i + 1), 63))));
+				}
+
+				__m256i seen = Load(visited + i);
+				added = _mm256_andnot_si256(seen, _mm256_and_si256(added, Load(passable + i)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(visited + i),
+					_mm256_or_si256(seen, added));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(next + i), added);
+			}
+		}
+
+		bool DetectAvx2()
+		{
+#if defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+				return false;
+
+			// The processor must have AVX and the system must save the YMM registers
+			__cpuid(info, 1);
+			if (!((info[2] >> 27) & 1) || !((info[2] >> 28) & 1) || (_xgetbv(0) & 6) != 6)
+				return false;
+
+			__cpuidex(info, 7, 0);
+			return ((info[1] >> 5) & 1) != 0;
+#else
+			return __builtin_cpu_supports("avx2") != 0;
+#endif
+		}
+#endif
+	}
+
+	BitFloodFill::BitFloodFill()
+		: touchedFirst(0), touchedLast(-1), frontierFirst(0), frontierLast(-1),
+		useAvx2(isAvx2Supported())
+	{
+	}
+
+	bool BitFloodFill::isAvx2Supported()
+	{
+#if defined(FULLSAIL_AI_BITBOARD_AVX2)
+		static bool const supported = DetectAvx2();
+		return supported;
+#else
+		return false;
+#endif
+	}
+
+	void BitFloodFill::setUseAvx2(bool _useAvx2)
+	{
+		useAvx2 = _useAvx2 && isAvx2Supported();
+	}
+
+	void BitFloodFill::Prepare(HexBitboard const& passable)
+	{
+		if (!visited.isSameSize(passable))
+		{
+			visited.resize(passable.getRowCount(), passable.getColumnCount());
+			frontier.resize(passable.getRowCount(), passable.getColumnCount());
+			next.resize(passable.getRowCount(), passable.getColumnCount());
+			frontierWords.resize(passable.getRowCount(), passable.getWordCount());
+			nextWords.resize(passable.getRowCount(), passable.getWordCount());
+		}
+		else
+		{
+			visited.clearRows(touchedFirst, touchedLast);
+			ClearFrontier();
+		}
+
+		touchedFirst = frontierFirst = 0;
+		touchedLast = frontierLast = -1;
+	}
+
+	void BitFloodFill::ClearFrontier()
+	{
+		int const markCount = frontierWords.getWordCount();
+		for (int row = frontierFirst; row <= frontierLast; ++row)
+		{
+			Word* words = frontier.getRow(row);
+			Word const* marks = frontierWords.getRow(row);
+			for (int j = 0; j < markCount; ++j)
+			{
+				for (Word mark = marks[j]; mark != 0; mark &= mark - 1)
+					words[(j << 6) + LowestBit(mark)] = 0;
+			}
+		}
+
+		frontierWords.clearRows(frontierFirst, frontierLast);
+	}
+
+	bool BitFloodFill::Expand(HexBitboard const& passable)
+	{
+		int const rowCount = passable.getRowCount();
+		int const wordCount = passable.getWordCount();
+		int const markCount = frontierWords.getWordCount();
+		int const first = frontierFirst > 0 ? frontierFirst - 1 : 0;
+		int const last = frontierLast + 1 < rowCount ? frontierLast + 1 : rowCount - 1;
+
+		void (*expandWords)(Word const*, Word const*, Word const*, Word const*, Word*, Word*,
+			int, bool) = ExpandWords;
+		int groupSize = 1;
+#if defined(FULLSAIL_AI_BITBOARD_AVX2)
+		if (useAvx2)
+		{
+			expandWords = ExpandWordsAvx2;
+			groupSize = 4;
+		}
+#endif
+
+		int addedFirst = rowCount;
+		int addedLast = -1;
+		for (int row = first; row <= last; ++row)
+		{
+			Word const* above = frontierWords.getRow(row - 1);
+			Word const* here = frontierWords.getRow(row);
+			Word const* below = frontierWords.getRow(row + 1);
+			Word* marks = nextWords.getRow(row);
+			Word* added = next.getRow(row);
+			int done = 0;
+			bool rowAdded = false;
+
+			for (int j = 0; j < markCount; ++j)
+			{
+				// Words next to a frontier word in this row or the rows around it
+				Word around = above[j] | here[j] | below[j];
+				Word candidates = around | (around << 1) | (around >> 1)
+					| ((above[j - 1] | here[j - 1] | below[j - 1]) >> 63)
+					| ((above[j + 1] | here[j + 1] | below[j + 1]) << 63);
+
+				while (candidates != 0)
+				{
+					// Take the lowest run of candidate words at once
+					int offset = LowestBit(candidates);
+					Word rest = ~(candidates >> offset);
+					int length = rest != 0 ? LowestBit(rest) : 64 - offset;
+					candidates = offset + length < 64 ? candidates & (~0ULL << (offset + length)) : 0;
+
+					int begin = (j << 6) + offset;
+					int end = begin + length < wordCount ? begin + length : wordCount;
+					begin = begin > done ? begin : done;
+					if (begin >= end)
+						continue;
+
+					int count = (end - begin + groupSize - 1) / groupSize * groupSize;
+					expandWords(frontier.getRow(row - 1) + begin, frontier.getRow(row) + begin,
+						frontier.getRow(row + 1) + begin, passable.getRow(row) + begin,
+						visited.getRow(row) + begin, added + begin, count, (row & 1) != 0);
+					done = begin + count;
+
+					// A group may run into the next candidates, which are then done too
+					for (int w = begin; w < done && w < wordCount; ++w)
+					{
+						if (added[w] != 0)
+						{
+							marks[w >> 6] |= 1ULL << (w & 63);
+							rowAdded = true;
+						}
+					}
+				}
+			}
+
+			if (rowAdded)
+			{
+				addedFirst = addedFirst < row ? addedFirst : row;
+				addedLast = row;
+			}
+		}
+
+		// The old frontier becomes the next level's empty buffer
+		ClearFrontier();
+		std::swap(frontier, next);
+		std::swap(frontierWords, nextWords);
+		frontierFirst = addedFirst;
+		frontierLast = addedLast;
+
+		if (addedLast < 0)
+			return false;
+
+		touchedFirst = addedFirst < touchedFirst ? addedFirst : touchedFirst;
+		touchedLast = addedLast > touchedLast ? addedLast : touchedLast;
+		return true;
+	}
+
+	bool BitFloodFill::GrowRow(HexBitboard const& passable, int row, bool force)
+	{
+		int const wordCount = passable.getWordCount();
+		Word const* open = passable.getRow(row);
+		Word const* above = visited.getRow(row - 1);
+		Word const* below = visited.getRow(row + 1);
+		Word* reached = visited.getRow(row);
+		Word* seeds = &rowSeeds[1];
+		bool const odd = (row & 1) != 0;
+
+		// Tiles touched from the rows around, as in ExpandWords
+		Word added = 0;
+		for (int i = 0; i < wordCount; ++i)
+		{
+			Word adjacent = above[i] | below[i];
+			Word touched = odd
+				? adjacent | (adjacent >> 1) | ((above[i + 1] | below[i + 1]) << 63)
+				: adjacent | (adjacent << 1) | ((above[i - 1] | below[i - 1]) >> 63);
+
+			seeds[i] = (reached[i] | touched) & open[i];
+			added |= seeds[i] & ~reached[i];
+		}
+
+		if (added == 0 && !force)
+			return false;
+
+		FillRuns(open, seeds, reached, wordCount);
+		return added != 0;
+	}
+
+	void BitFloodFill::Sweep(HexBitboard const& passable)
+	{
+		int const rowCount = passable.getRowCount();
+		rowSeeds.resize(passable.getWordCount() + 2);
+
+		for (bool changed = true; changed; )
+		{
+			changed = false;
+
+			// Down from the first reached row, and on past the last while rows keep growing
+			for (int row = touchedFirst; row < rowCount && row <= touchedLast + 1; ++row)
+			{
+				if (GrowRow(passable, row, false))
+				{
+					changed = true;
+					touchedLast = row > touchedLast ? row : touchedLast;
+				}
+			}
+
+			for (int row = touchedLast; row >= 0 && row >= touchedFirst - 1; --row)
+			{
+				if (GrowRow(passable, row, false))
+				{
+					changed = true;
+					touchedFirst = row < touchedFirst ? row : touchedFirst;
+				}
+			}
+		}
+	}
+
+	int BitFloodFill::Search(HexBitboard const& passable, int source, int maxHops, int target,
+		std::vector<int>* hops)
+	{
+		int const columnCount = passable.getColumnCount();
+
+		Prepare(passable);
+		if (hops != 0)
+			hops->assign(passable.getRowCount() * columnCount, -1);
+
+		if (source < 0 || !passable.test(source))
+			return -1;
+
+		int row = source / columnCount;
+		visited.set(row, source % columnCount);
+		frontier.set(row, source % columnCount);
+		frontierWords.set(row, (source % columnCount) >> 6);
+		touchedFirst = touchedLast = frontierFirst = frontierLast = row;
+		if (hops != 0)
+			(*hops)[source] = 0;
+
+		if (target == source)
+			return 0;
+
+		int level = 0;
+		while (level < maxHops && Expand(passable))
+		{
+			++level;
+
+			if (hops != 0)
+			{
+				for (int r = frontierFirst; r <= frontierLast; ++r)
+				{
+					Word const* bits = frontier.getRow(r);
+					Word const* marks = frontierWords.getRow(r);
+					for (int j = 0; j < frontierWords.getWordCount(); ++j)
+					{
+						for (Word mark = marks[j]; mark != 0; mark &= mark - 1)
+						{
+							int w = (j << 6) + LowestBit(mark);
+							for (Word word = bits[w]; word != 0; word &= word - 1)
+								(*hops)[r * columnCount + (w << 6) + LowestBit(word)] = level;
+						}
+					}
+				}
+			}
+
+			if (target >= 0 && visited.test(target))
+				return level;
+		}
+
+		return target >= 0 ? -1 : level;
+	}
+
+	int BitFloodFill::fill(HexBitboard const& passable, int source)
+	{
+		Prepare(passable);
+		if (source < 0 || !passable.test(source))
+			return 0;
+
+		int row = source / passable.getColumnCount();
+		visited.set(row, source % passable.getColumnCount());
+		touchedFirst = touchedLast = row;
+		rowSeeds.resize(passable.getWordCount() + 2);
+		GrowRow(passable, row, true);
+		Sweep(passable);
+
+		return visited.countRows(touchedFirst, touchedLast);
+	}
+
+	int BitFloodFill::fillWithin(HexBitboard const& passable, int source, int maxHops)
+	{
+		if (Search(passable, source, maxHops, -1, 0) < 0)
+			return 0;
+
+		return visited.countRows(touchedFirst, touchedLast);
+	}
+
+	int BitFloodFill::getHopDistance(HexBitboard const& passable, int source, int target,
+		int maxHops)
+	{
+		return Search(passable, source, maxHops, target, 0);
+	}
+
+	int BitFloodFill::computeHops(HexBitboard const& passable, int source,
+		std::vector<int>& hops, int maxHops)
+	{
+		return Search(passable, source, maxHops, -1, &hops);
+	}
+
+	int BitFloodFill::labelComponents(HexBitboard const& passable, std::vector<int>& labels)
+	{
+		int const columnCount = passable.getColumnCount();
+		int const wordCount = passable.getWordCount();
+		labels.assign(passable.getRowCount() * columnCount, -1);
+
+		// Passable tiles not labelled yet
+		HexBitboard remaining(passable);
+		int componentCount = 0;
+
+		for (int row = 0; row < passable.getRowCount(); ++row)
+		{
+			for (int w = 0; w < wordCount; ++w)
+			{
+				while (remaining.getRow(row)[w] != 0)
+				{
+					int column = (w << 6) + LowestBit(remaining.getRow(row)[w]);
+					fill(passable, row * columnCount + column);
+
+					for (int r = touchedFirst; r <= touchedLast; ++r)
+					{
+						Word const* bits = visited.getRow(r);
+						Word* left = remaining.getRow(r);
+						for (int i = 0; i < wordCount; ++i)
+						{
+							left[i] &= ~bits[i];
+							for (Word word = bits[i]; word != 0; word &= word - 1)
+								labels[r * columnCount + (i << 6) + LowestBit(word)] = componentCount;
+						}
+					}
+
+					++componentCount;
+				}
+			}
+		}
+
+		return componentCount;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,136 @@
+//! \file BitFloodFill.h
+//! \brief Defines the fullsail_ai::algorithms::BitFloodFill class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_BIT_FLOOD_FILL_H_
+#define _FULLSAIL_AI_PATH_PLANNER_BIT_FLOOD_FILL_H_
+
+#include <vector>
+#include "HexBitboard.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Breadth-first search over the passable tiles that counts moves and ignores
+	//! weights, for reachability, move ranges, connected components and unweighted maps.
+	//!
+	//! The frontier is a <code>HexBitboard</code> and is expanded a whole level at a time:
+	//! each row of the next level is the frontier row shifted one column either way, plus
+	//! the rows above and below, shifted toward the columns they touch (left on even rows,
+	//! right on odd ones), masked with the passable tiles not yet visited.  That handles 64
+	//! tiles per word operation, or 256 with AVX2, which is used when the processor has it.
+	//! Only the words around the frontier are processed, so a level costs time in proportion
+	//! to the frontier rather than to the map.
+	//!
+	//! Plain reachability needs no levels, so <code>fill()</code> and
+	//! <code>labelComponents()</code> instead sweep the rows down and up: each row takes the
+	//! tiles touched by its reached neighbors and grows them to whole runs of passable tiles
+	//! with a few shifts per word.  A sweep or two usually settles an open map, where the
+	//! search by levels needs one step per move across it.
+	class BitFloodFill
+	{
+		HexBitboard visited;
+		HexBitboard frontier;
+		HexBitboard next;
+		// One bit per word of the frontier and of the next level, set if the word is not
+		// zero, so that a level only visits the words around the frontier
+		HexBitboard frontierWords;
+		HexBitboard nextWords;
+		// Rows of visited tiles, and of the current frontier
+		int touchedFirst;
+		int touchedLast;
+		int frontierFirst;
+		int frontierLast;
+		std::vector<unsigned long long> rowSeeds;
+		bool useAvx2;
+
+		//! \brief Clears what the last search left and makes the boards the size of the mask.
+		void Prepare(HexBitboard const& passable);
+
+		//! \brief Clears the words of the frontier.
+		void ClearFrontier();
+
+		//! \brief Expands the frontier one level.  Returns false if no tile was added.
+		bool Expand(HexBitboard const& passable);
+
+		//! \brief Adds the tiles of a row touched by the visited tiles of the rows around it,
+		//! and grows them to whole runs.  Returns true if the row changed.
+		bool GrowRow(HexBitboard const& passable, int row, bool force);
+
+		//! \brief Grows the visited tiles to everything they reach by sweeping rows.
+		void Sweep(HexBitboard const& passable);
+
+		//! \brief Runs the search; see the public methods.
+		int Search(HexBitboard const& passable, int source, int maxHops, int target,
+			std::vector<int>* hops);
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT BitFloodFill();
+
+		//! \brief Returns true if the processor supports AVX2.
+		DLLEXPORT static bool isAvx2Supported();
+
+		//! \brief Selects the AVX2 kernel, if the processor supports it, or the portable one.
+		//!
+		//! AVX2 is used by default where available.
+		DLLEXPORT void setUseAvx2(bool _useAvx2);
+
+		inline bool isUsingAvx2() const
+		{
+			return useAvx2;
+		}
+
+		//! \brief Finds every tile the source reaches.
+		//!
+		//! \param   passable  the passable tiles, as built by
+		//!                    <code>HexBitboard::build()</code>.
+		//! \param   source    index of the tile to start from.
+		//! \return  the number of tiles reached, zero if the source is impassable.
+		DLLEXPORT int fill(HexBitboard const& passable, int source);
+
+		//! \brief Finds every tile the source reaches in at most <code>maxHops</code> moves,
+		//! such as a unit's move range.
+		//!
+		//! \return  the number of tiles reached, zero if the source is impassable.
+		DLLEXPORT int fillWithin(HexBitboard const& passable, int source, int maxHops);
+
+		//! \brief Counts the moves between two tiles.
+		//!
+		//! Stops as soon as the target is reached.
+		//!
+		//! \return  the number of moves, or -1 if the target is not reached within
+		//!          <code>maxHops</code>.
+		DLLEXPORT int getHopDistance(HexBitboard const& passable, int source, int target,
+			int maxHops = 0x7FFFFFFF);
+
+		//! \brief Finds every tile the source reaches, and the moves each takes.
+		//!
+		//! \param   hops     receives one count per tile, -1 for tiles not reached.
+		//! \param   maxHops  the most moves a tile may take to reach.
+		//! \return  the most moves any reached tile takes, or -1 if the source is
+		//!          impassable.
+		DLLEXPORT int computeHops(HexBitboard const& passable, int source, std::vector<int>& hops,
+			int maxHops = 0x7FFFFFFF);
+
+		//! \brief Numbers the connected regions of passable tiles.
+		//!
+		//! \param   passable  the passable tiles.
+		//! \param   labels    receives the region of each tile, from 0 in row-major order of
+		//!                    their first tiles, and -1 for impassable tiles.
+		//! \return  the number of regions.
+		DLLEXPORT int labelComponents(HexBitboard const& passable, std::vector<int>& labels);
+
+		//! \brief Returns the tiles reached by the last search.
+		inline HexBitboard const& getReached() const
+		{
+			return visited;
+		}
+
+		//! \brief Returns true if the last search reached the tile at a row-major index.
+		inline bool isReached(int index) const
+		{
+			return visited.test(index);
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_BIT_FLOOD_FILL_H_
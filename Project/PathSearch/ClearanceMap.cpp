@@ -0,0 +1,180 @@
+#include <queue>
+#include <functional>
+#include "ClearanceMap.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		unsigned short const UNSET = 0xFFFF;
+
+		// Tiles on the edge of the map are one move from the off-map tiles, which count as
+		// walls
+		bool IsOnEdge(HexGraph const& graph, int tile)
+		{
+			for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+			{
+				if (graph.getAdjacent(tile, d) < 0)
+					return true;
+			}
+
+			return false;
+		}
+	}
+
+	ClearanceMap::ClearanceMap()
+	{
+	}
+
+	void ClearanceMap::build(HexGraph const& graph)
+	{
+		int const tiles = graph.getTileCount();
+		distances.assign(tiles, UNSET);
+
+		// Walls first, then the edge, so the queue stays ordered by distance
+		std::vector<int> queue;
+		queue.reserve(tiles);
+		for (int tile = 0; tile < tiles; ++tile)
+		{
+			if (!graph.isPassable(tile))
+			{
+				distances[tile] = 0;
+				queue.push_back(tile);
+			}
+		}
+		for (int tile = 0; tile < tiles; ++tile)
+		{
+			if (distances[tile] == UNSET && IsOnEdge(graph, tile))
+			{
+				distances[tile] = 1;
+				queue.push_back(tile);
+			}
+		}
+
+		// Every move costs one, so the first distance a tile gets is final
+		for (int i = 0; i < static_cast<int>(queue.size()); ++i)
+		{
+			int tile = queue[i];
+			unsigned short next = distances[tile] + 1;
+
+			for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+			{
+				int adjacent = graph.getAdjacent(tile, d);
+				if (adjacent >= 0 && distances[adjacent] == UNSET)
+				{
+					distances[adjacent] = next;
+					queue.push_back(adjacent);
+				}
+			}
+		}
+	}
+
+	void ClearanceMap::clear()
+	{
+		distances.clear();
+	}
+
+	void ClearanceMap::setPassable(HexGraph const& graph, int tile, bool passable)
+	{
+		if (passable == (distances[tile] != 0))
+			return;
+
+		std::vector<int> changed(1, tile);
+
+		if (!passable)
+		{
+			distances[tile] = 0;
+			Propagate(graph, changed);
+			return;
+		}
+
+		// Opening a wall can only move tiles further from a wall.  Walk outwards level by
+		// level and unset every tile left without a neighbor one move nearer; each level is
+		// settled before the next is checked, as its tiles were all queued while walking the
+		// one before.
+		std::vector<unsigned short> levels(1, 0);
+		distances[tile] = UNSET;
+
+		for (int i = 0; i < static_cast<int>(changed.size()); ++i)
+		{
+			int level = levels[i];
+
+			for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+			{
+				int adjacent = graph.getAdjacent(changed[i], d);
+				if (adjacent < 0 || distances[adjacent] != level + 1)
+					continue;
+				// The edge always holds tiles at one move
+				if (level == 0 && IsOnEdge(graph, adjacent))
+					continue;
+
+				bool supported = false;
+				for (int e = 0; e < HexGraph::DIRECTION_COUNT && !supported; ++e)
+				{
+					int other = graph.getAdjacent(adjacent, e);
+					supported = other >= 0 && distances[other] == level;
+				}
+
+				if (!supported)
+				{
+					distances[adjacent] = UNSET;
+					changed.push_back(adjacent);
+					levels.push_back(static_cast<unsigned short>(level + 1));
+				}
+			}
+		}
+
+		// Give each unset tile the best distance its settled neighbors offer, then let the
+		// lower ones spread
+		for (int i = 0; i < static_cast<int>(changed.size()); ++i)
+		{
+			int current = changed[i];
+			unsigned short best = IsOnEdge(graph, current) ? 1 : UNSET;
+
+			for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+			{
+				int adjacent = graph.getAdjacent(current, d);
+				if (adjacent >= 0 && distances[adjacent] != UNSET
+					&& distances[adjacent] + 1 < best)
+					best = distances[adjacent] + 1;
+			}
+
+			distances[current] = best;
+		}
+
+		Propagate(graph, changed);
+	}
+
+	void ClearanceMap::Propagate(HexGraph const& graph, std::vector<int> const& seeds)
+	{
+		typedef std::pair<unsigned short, int> Entry;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+
+		for (int i = 0; i < static_cast<int>(seeds.size()); ++i)
+		{
+			if (distances[seeds[i]] != UNSET)
+				open.push(Entry(distances[seeds[i]], seeds[i]));
+		}
+
+		while (!open.empty())
+		{
+			Entry current = open.top();
+			open.pop();
+
+			// Skip stale entries left behind by nearer pushes
+			if (current.first != distances[current.second])
+				continue;
+
+			unsigned short next = current.first + 1;
+			for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+			{
+				int adjacent = graph.getAdjacent(current.second, d);
+				if (adjacent >= 0 && next < distances[adjacent])
+				{
+					distances[adjacent] = next;
+					open.push(Entry(next, adjacent));
+				}
+			}
+		}
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,70 @@
+//! \file ClearanceMap.h
+//! \brief Defines the fullsail_ai::algorithms::ClearanceMap class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_CLEARANCE_MAP_H_
+#define _FULLSAIL_AI_PATH_PLANNER_CLEARANCE_MAP_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief How much room there is around every tile, so that large units keep out of gaps
+	//! they do not fit through.
+	//!
+	//! The clearance of a passable tile is the radius of the largest hex disc of passable
+	//! tiles centered on it: zero next to a wall or the edge of the map, one if all six
+	//! neighbors are open, and so on.  A unit of radius <code>k</code> may stand on a tile
+	//! whose clearance is at least <code>k</code>.
+	//!
+	//! The map is a distance transform: a breadth-first pass from every wall, and from the
+	//! edge of the map, over all tiles, which takes time linear in the size of the map.  When
+	//! a tile opens or closes, only the tiles whose distance changes are visited again.
+	class ClearanceMap
+	{
+		// Moves from each tile to the nearest wall or off-map tile; zero for walls
+		std::vector<unsigned short> distances;
+
+		//! \brief Lowers the distances around the seed tiles, nearest first.
+		void Propagate(HexGraph const& graph, std::vector<int> const& seeds);
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT ClearanceMap();
+
+		//! \brief Computes the clearance of every tile in the graph.
+		DLLEXPORT void build(HexGraph const& graph);
+
+		//! \brief Releases the map.
+		DLLEXPORT void clear();
+
+		//! \brief Updates the map after a tile became a wall or was opened.
+		//!
+		//! \param   graph     the graph the map was built from; only its size is read, so it
+		//!                    need not have been rebuilt since the change.
+		//! \param   tile      index of the tile that changed.
+		//! \param   passable  true if the tile can now be entered.
+		DLLEXPORT void setPassable(HexGraph const& graph, int tile, bool passable);
+
+		//! \brief Returns true if the map was built for a graph of this size.
+		inline bool isValidFor(HexGraph const& graph) const
+		{
+			return static_cast<int>(distances.size()) == graph.getTileCount()
+				&& !distances.empty();
+		}
+
+		//! \brief Returns the clearance of a tile, or -1 if it is a wall.
+		inline int getClearance(int tile) const
+		{
+			return static_cast<int>(distances[tile]) - 1;
+		}
+
+		//! \brief Returns true if a unit of the specified radius fits on the tile.
+		inline bool fits(int tile, int radius) const
+		{
+			return static_cast<int>(distances[tile]) > radius;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_CLEARANCE_MAP_H_
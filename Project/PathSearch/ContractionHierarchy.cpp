@@ -0,0 +1,649 @@
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <cstring>
+#include "ContractionHierarchy.h"
+#include "Parallel.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		char const HIERARCHY_FILE_TAG[4] = { 'C', 'H', '0', '1' };
+
+		// Witness searches give up after settling this many tiles; a missed witness only
+		// costs an unnecessary shortcut.  Estimating priorities uses a much smaller limit.
+		int const WITNESS_SETTLE_LIMIT = 128;
+		int const PRIORITY_SETTLE_LIMIT = 8;
+
+		struct BuildEdge
+		{
+			int other;
+			unsigned int cost;
+			int middle;
+		};
+
+		struct Shortcut
+		{
+			int from;
+			int to;
+			unsigned int cost;
+			int middle;
+		};
+
+		typedef std::vector<std::vector<BuildEdge> > AdjacencyList;
+		typedef std::pair<unsigned int, int> OpenEntry;
+
+		//! Remaining (uncontracted) graph while preprocessing.
+		struct Contractor
+		{
+			AdjacencyList out;
+			AdjacencyList in;
+			std::vector<int> contractedNeighbors;
+			std::vector<int> levels;
+			std::vector<char> excluded;
+		};
+
+		//! Witness search scratch owned by one worker thread.
+		struct WitnessScratch
+		{
+			std::vector<unsigned int> costs;
+			std::vector<int> touched;
+			std::vector<OpenEntry> open;
+		};
+
+		// Bounded Dijkstra from source that ignores the tile being contracted and every tile
+		// contracted in the same round.  Leaves costs of touched tiles in scratch.costs.
+		void FindWitnesses(Contractor const& graph, int source, int ignored,
+			unsigned int maxCost, int settleLimit, WitnessScratch& scratch)
+		{
+			for (size_t i = 0; i < scratch.touched.size(); ++i)
+				scratch.costs[scratch.touched[i]] = HexGraph::INFINITE_COST;
+			scratch.touched.clear();
+			scratch.open.clear();
+
+			scratch.costs[source] = 0;
+			scratch.touched.push_back(source);
+			scratch.open.push_back(OpenEntry(0, source));
+
+			for (int settled = 0; !scratch.open.empty() && settled < settleLimit; )
+			{
+				std::pop_heap(scratch.open.begin(), scratch.open.end(), std::greater<OpenEntry>());
+				OpenEntry current = scratch.open.back();
+				scratch.open.pop_back();
+
+				if (current.first != scratch.costs[current.second])
+					continue;
+				if (current.first > maxCost)
+					break;
+				++settled;
+
+				std::vector<BuildEdge> const& edges = graph.out[current.second];
+				for (size_t e = 0; e < edges.size(); ++e)
+				{
+					int next = edges[e].other;
+					if (next == ignored || graph.excluded[next])
+						continue;
+
+					unsigned int cost = current.first + edges[e].cost;
+					if (cost < scratch.costs[next] && cost <= maxCost)
+					{
+						if (scratch.costs[next] == HexGraph::INFINITE_COST)
+							scratch.touched.push_back(next);
+						scratch.costs[next] = cost;
+						scratch.open.push_back(OpenEntry(cost, next));
+						std::push_heap(scratch.open.begin(), scratch.open.end(),
+							std::greater<OpenEntry>());
+					}
+				}
+			}
+		}
+
+		// Finds the shortcuts that contracting the tile would need.  Returns their count and
+		// appends them to shortcuts when it is not NULL; otherwise only estimates the count.
+		int ContractTile(Contractor const& graph, int tile, WitnessScratch& scratch,
+			std::vector<Shortcut>* shortcuts)
+		{
+			std::vector<BuildEdge> const& in = graph.in[tile];
+			std::vector<BuildEdge> const& out = graph.out[tile];
+			int count = 0;
+
+			unsigned int maxOut = 0;
+			for (size_t o = 0; o < out.size(); ++o)
+			{
+				if (out[o].cost > maxOut)
+					maxOut = out[o].cost;
+			}
+
+			for (size_t i = 0; i < in.size(); ++i)
+			{
+				int from = in[i].other;
+				FindWitnesses(graph, from, tile, in[i].cost + maxOut,
+					shortcuts != 0 ? WITNESS_SETTLE_LIMIT : PRIORITY_SETTLE_LIMIT, scratch);
+
+				for (size_t o = 0; o < out.size(); ++o)
+				{
+					int to = out[o].other;
+					unsigned int cost = in[i].cost + out[o].cost;
+
+					if (to == from || scratch.costs[to] <= cost)
+						continue;
+
+					++count;
+					if (shortcuts != 0)
+					{
+						Shortcut shortcut = { from, to, cost, tile };
+						shortcuts->push_back(shortcut);
+					}
+				}
+			}
+
+			return count;
+		}
+
+		// Adds an edge to the remaining graph, or lowers the cost of an existing one.
+		void AddEdge(Contractor& graph, Shortcut const& shortcut)
+		{
+			std::vector<BuildEdge>& out = graph.out[shortcut.from];
+			for (size_t e = 0; e < out.size(); ++e)
+			{
+				if (out[e].other != shortcut.to)
+					continue;
+
+				if (shortcut.cost < out[e].cost)
+				{
+					out[e].cost = shortcut.cost;
+					out[e].middle = shortcut.middle;
+
+					std::vector<BuildEdge>& in = graph.in[shortcut.to];
+					for (size_t r = 0; r < in.size(); ++r)
+					{
+						if (in[r].other == shortcut.from)
+						{
+							in[r].cost = shortcut.cost;
+							in[r].middle = shortcut.middle;
+						}
+					}
+				}
+				return;
+			}
+
+			BuildEdge forward = { shortcut.to, shortcut.cost, shortcut.middle };
+			BuildEdge backward = { shortcut.from, shortcut.cost, shortcut.middle };
+			out.push_back(forward);
+			graph.in[shortcut.to].push_back(backward);
+		}
+
+		void RemoveEdgesTo(std::vector<BuildEdge>& edges, int other)
+		{
+			for (size_t e = 0; e < edges.size(); )
+			{
+				if (edges[e].other == other)
+				{
+					edges[e] = edges.back();
+					edges.pop_back();
+				}
+				else
+				{
+					++e;
+				}
+			}
+		}
+
+		template <typename T>
+		void WriteVector(std::ofstream& output, std::vector<T> const& values)
+		{
+			int count = static_cast<int>(values.size());
+			output.write(reinterpret_cast<char const*>(&count), sizeof(count));
+			if (count)
+				output.write(reinterpret_cast<char const*>(&values[0]), count * sizeof(T));
+		}
+
+		template <typename T>
+		bool ReadVector(std::ifstream& input, std::vector<T>& values)
+		{
+			int count = 0;
+			input.read(reinterpret_cast<char*>(&count), sizeof(count));
+			if (!input.good() || count < 0)
+				return false;
+
+			values.resize(count);
+			if (count)
+				input.read(reinterpret_cast<char*>(&values[0]), count * sizeof(T));
+			return input.good();
+		}
+	}
+
+	ContractionHierarchy::Query::Query()
+		: stamp(0), settledCount(0)
+	{
+	}
+
+	ContractionHierarchy::ContractionHierarchy()
+		: tileCount(0), checksum(0), shortcutCount(0)
+	{
+	}
+
+	void ContractionHierarchy::clear()
+	{
+		ranks.clear();
+		firstForward.clear();
+		forwardEdges.clear();
+		firstBackward.clear();
+		backwardEdges.clear();
+		tileCount = 0;
+		checksum = 0;
+		shortcutCount = 0;
+	}
+
+	void ContractionHierarchy::build(HexGraph const& graph, unsigned int threadCount)
+	{
+		clear();
+		if (threadCount == 0)
+			threadCount = getDefaultThreadCount();
+
+		int const tiles = graph.getTileCount();
+		Contractor remaining;
+		remaining.out.resize(tiles);
+		remaining.in.resize(tiles);
+		remaining.contractedNeighbors.assign(tiles, 0);
+		remaining.levels.assign(tiles, 0);
+		remaining.excluded.assign(tiles, 0);
+
+		std::vector<int> active;
+		for (int tile = 0; tile < tiles; ++tile)
+		{
+			if (!graph.isPassable(tile))
+				continue;
+
+			active.push_back(tile);
+			for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+			{
+				int neighbor = graph.getNeighbor(tile, d);
+				if (neighbor < 0)
+					continue;
+
+				BuildEdge forward = { neighbor, graph.getWeight(neighbor), -1 };
+				BuildEdge backward = { tile, graph.getWeight(neighbor), -1 };
+				remaining.out[tile].push_back(forward);
+				remaining.in[neighbor].push_back(backward);
+			}
+		}
+
+		std::vector<WitnessScratch> scratch(threadCount);
+		for (unsigned int t = 0; t < threadCount; ++t)
+			scratch[t].costs.assign(tiles, HexGraph::INFINITE_COST);
+
+		std::vector<int> priorities(tiles, 0);
+		std::vector<char> dirty(tiles, 1);
+		std::vector<std::vector<BuildEdge> > upOut(tiles);
+		std::vector<std::vector<BuildEdge> > upIn(tiles);
+		std::vector<std::vector<Shortcut> > roundShortcuts;
+		std::vector<int> stale;
+		std::vector<int> selected;
+		ranks.assign(tiles, -1);
+		int nextRank = 0;
+
+		while (!active.empty())
+		{
+			// Edge difference plus contracted neighbors and hierarchy depth, for tiles whose
+			// neighborhood changed
+			stale.clear();
+			for (size_t a = 0; a < active.size(); ++a)
+			{
+				if (dirty[active[a]])
+					stale.push_back(active[a]);
+			}
+
+			parallelFor(static_cast<int>(stale.size()), [&](int s, unsigned int worker)
+			{
+				int tile = stale[s];
+				int added = ContractTile(remaining, tile, scratch[worker], 0);
+				int removed = static_cast<int>(remaining.in[tile].size()
+					+ remaining.out[tile].size());
+				priorities[tile] = 2 * (added - removed) + remaining.contractedNeighbors[tile]
+					+ remaining.levels[tile];
+				dirty[tile] = 0;
+			}, threadCount);
+
+			// Contract every tile that is less important than all of its neighbors
+			std::vector<char> isSelected(active.size(), 0);
+			parallelFor(static_cast<int>(active.size()), [&](int a, unsigned int)
+			{
+				int tile = active[a];
+				std::pair<int, int> key(priorities[tile], tile);
+
+				for (int side = 0; side < 2; ++side)
+				{
+					std::vector<BuildEdge> const& edges = side ? remaining.in[tile]
+						: remaining.out[tile];
+					for (size_t e = 0; e < edges.size(); ++e)
+					{
+						int other = edges[e].other;
+						if (std::pair<int, int>(priorities[other], other) < key)
+							return;
+					}
+				}
+				isSelected[a] = 1;
+			}, threadCount);
+
+			selected.clear();
+			for (size_t a = 0; a < active.size(); ++a)
+			{
+				if (isSelected[a])
+				{
+					selected.push_back(active[a]);
+					remaining.excluded[active[a]] = 1;
+				}
+			}
+
+			roundShortcuts.assign(selected.size(), std::vector<Shortcut>());
+			parallelFor(static_cast<int>(selected.size()), [&](int s, unsigned int worker)
+			{
+				ContractTile(remaining, selected[s], scratch[worker], &roundShortcuts[s]);
+			}, threadCount);
+
+			// Apply the round sequentially
+			for (size_t s = 0; s < selected.size(); ++s)
+			{
+				int tile = selected[s];
+				ranks[tile] = nextRank++;
+				upOut[tile].swap(remaining.out[tile]);
+				upIn[tile].swap(remaining.in[tile]);
+
+				for (size_t e = 0; e < upOut[tile].size(); ++e)
+				{
+					int other = upOut[tile][e].other;
+					RemoveEdgesTo(remaining.in[other], tile);
+					++remaining.contractedNeighbors[other];
+					if (remaining.levels[other] <= remaining.levels[tile])
+						remaining.levels[other] = remaining.levels[tile] + 1;
+					dirty[other] = 1;
+				}
+				for (size_t e = 0; e < upIn[tile].size(); ++e)
+				{
+					int other = upIn[tile][e].other;
+					RemoveEdgesTo(remaining.out[other], tile);
+					++remaining.contractedNeighbors[other];
+					if (remaining.levels[other] <= remaining.levels[tile])
+						remaining.levels[other] = remaining.levels[tile] + 1;
+					dirty[other] = 1;
+				}
+			}
+
+			for (size_t s = 0; s < selected.size(); ++s)
+			{
+				for (size_t c = 0; c < roundShortcuts[s].size(); ++c)
+				{
+					AddEdge(remaining, roundShortcuts[s][c]);
+					++shortcutCount;
+				}
+			}
+
+			size_t kept = 0;
+			for (size_t a = 0; a < active.size(); ++a)
+			{
+				if (!remaining.excluded[active[a]])
+					active[kept++] = active[a];
+			}
+			active.resize(kept);
+		}
+
+		// Flatten the upward edges
+		firstForward.assign(tiles + 1, 0);
+		firstBackward.assign(tiles + 1, 0);
+		for (int tile = 0; tile < tiles; ++tile)
+		{
+			firstForward[tile + 1] = firstForward[tile] + static_cast<int>(upOut[tile].size());
+			firstBackward[tile + 1] = firstBackward[tile] + static_cast<int>(upIn[tile].size());
+		}
+
+		forwardEdges.resize(firstForward[tiles]);
+		backwardEdges.resize(firstBackward[tiles]);
+		for (int tile = 0; tile < tiles; ++tile)
+		{
+			for (size_t e = 0; e < upOut[tile].size(); ++e)
+			{
+				Edge edge = { upOut[tile][e].other, upOut[tile][e].cost, upOut[tile][e].middle };
+				forwardEdges[firstForward[tile] + e] = edge;
+			}
+			for (size_t e = 0; e < upIn[tile].size(); ++e)
+			{
+				Edge edge = { upIn[tile][e].other, upIn[tile][e].cost, upIn[tile][e].middle };
+				backwardEdges[firstBackward[tile] + e] = edge;
+			}
+		}
+
+		tileCount = tiles;
+		checksum = graph.getChecksum();
+	}
+
+	unsigned int ContractionHierarchy::Search(int start, int goal, Query& query,
+		int& meeting) const
+	{
+		meeting = -1;
+		query.settledCount = 0;
+		if (start < 0 || goal < 0 || start >= tileCount || goal >= tileCount
+			|| ranks[start] < 0 || ranks[goal] < 0)
+			return HexGraph::INFINITE_COST;
+
+		if (query.forward.size() != static_cast<size_t>(tileCount) || ++query.stamp == 0)
+		{
+			Query::Label blank = { HexGraph::INFINITE_COST, 0, -1, -1 };
+			query.forward.assign(tileCount, blank);
+			query.backward.assign(tileCount, blank);
+			query.stamp = 1;
+		}
+
+		unsigned int const stamp = query.stamp;
+		std::vector<Query::Label>* labels[2] = { &query.forward, &query.backward };
+		std::vector<OpenEntry>* open[2] = { &query.forwardOpen, &query.backwardOpen };
+		int const* first[2] = { &firstForward[0], &firstBackward[0] };
+		Edge const* edges[2] = { forwardEdges.empty() ? 0 : &forwardEdges[0],
+			backwardEdges.empty() ? 0 : &backwardEdges[0] };
+		int const sources[2] = { start, goal };
+
+		for (int side = 0; side < 2; ++side)
+		{
+			Query::Label& label = (*labels[side])[sources[side]];
+			label.cost = 0;
+			label.stamp = stamp;
+			label.parent = label.parentEdge = -1;
+			open[side]->assign(1, OpenEntry(0, sources[side]));
+		}
+
+		unsigned int best = HexGraph::INFINITE_COST;
+
+		for (;;)
+		{
+			unsigned int forwardMin = open[0]->empty() ? HexGraph::INFINITE_COST
+				: open[0]->front().first;
+			unsigned int backwardMin = open[1]->empty() ? HexGraph::INFINITE_COST
+				: open[1]->front().first;
+			if (forwardMin >= best && backwardMin >= best)
+				break;
+
+			int side = forwardMin <= backwardMin ? 0 : 1;
+			std::vector<OpenEntry>& heap = *open[side];
+			std::pop_heap(heap.begin(), heap.end(), std::greater<OpenEntry>());
+			OpenEntry current = heap.back();
+			heap.pop_back();
+
+			std::vector<Query::Label>& mine = *labels[side];
+			if (current.first != mine[current.second].cost)
+				continue;
+			++query.settledCount;
+
+			Query::Label const& theirs = (*labels[1 - side])[current.second];
+			if (theirs.stamp == stamp && current.first + theirs.cost < best)
+			{
+				best = current.first + theirs.cost;
+				meeting = current.second;
+			}
+
+			// Stall-on-demand: a cheaper route arrives through a more important tile, so this
+			// label cannot lie on a shortest path and its edges need no relaxing
+			bool stalled = false;
+			for (int e = first[1 - side][current.second];
+				e < first[1 - side][current.second + 1] && !stalled; ++e)
+			{
+				Edge const& edge = edges[1 - side][e];
+				Query::Label const& above = mine[edge.other];
+				stalled = above.stamp == stamp && above.cost + edge.cost < current.first;
+			}
+			if (stalled)
+				continue;
+
+			for (int e = first[side][current.second]; e < first[side][current.second + 1]; ++e)
+			{
+				Edge const& edge = edges[side][e];
+				unsigned int cost = current.first + edge.cost;
+				Query::Label& next = mine[edge.other];
+
+				if (next.stamp != stamp || cost < next.cost)
+				{
+					next.cost = cost;
+					next.stamp = stamp;
+					next.parent = current.second;
+					next.parentEdge = e;
+					heap.push_back(OpenEntry(cost, edge.other));
+					std::push_heap(heap.begin(), heap.end(), std::greater<OpenEntry>());
+				}
+			}
+		}
+
+		return best;
+	}
+
+	unsigned int ContractionHierarchy::findCost(int start, int goal, Query& query) const
+	{
+		int meeting;
+		return Search(start, goal, query, meeting);
+	}
+
+	void ContractionHierarchy::UnpackEdge(int from, int to, int middle,
+		std::vector<int>& tiles) const
+	{
+		if (middle < 0)
+		{
+			tiles.push_back(to);
+			return;
+		}
+
+		// The bypassed tile ranks below both ends, so both halves are stored at it
+		int firstMiddle = -1;
+		for (int e = firstBackward[middle]; e < firstBackward[middle + 1]; ++e)
+		{
+			if (backwardEdges[e].other == from)
+				firstMiddle = backwardEdges[e].middle;
+		}
+
+		int secondMiddle = -1;
+		for (int e = firstForward[middle]; e < firstForward[middle + 1]; ++e)
+		{
+			if (forwardEdges[e].other == to)
+				secondMiddle = forwardEdges[e].middle;
+		}
+
+		UnpackEdge(from, middle, firstMiddle, tiles);
+		UnpackEdge(middle, to, secondMiddle, tiles);
+	}
+
+	unsigned int ContractionHierarchy::findPath(HexGraph const& graph, int start, int goal,
+		std::vector<Tile const*>& path, Query& query) const
+	{
+		path.clear();
+
+		int meeting;
+		unsigned int cost = Search(start, goal, query, meeting);
+		if (cost == HexGraph::INFINITE_COST)
+			return cost;
+
+		// Forward half, collected from the meeting tile back to the start
+		std::vector<int> climb;
+		for (int tile = meeting; tile != start; tile = query.forward[tile].parent)
+			climb.push_back(tile);
+
+		std::vector<int> tiles(1, start);
+		for (size_t c = climb.size(); c-- > 0; )
+		{
+			int tile = climb[c];
+			Query::Label const& label = query.forward[tile];
+			UnpackEdge(label.parent, tile, forwardEdges[label.parentEdge].middle, tiles);
+		}
+
+		// Backward half, from the meeting tile down to the goal
+		for (int tile = meeting; tile != goal; tile = query.backward[tile].parent)
+		{
+			Query::Label const& label = query.backward[tile];
+			UnpackEdge(tile, label.parent, backwardEdges[label.parentEdge].middle, tiles);
+		}
+
+		path.reserve(tiles.size());
+		for (size_t t = tiles.size(); t-- > 0; )
+			path.push_back(graph.getTile(tiles[t]));
+
+		return cost;
+	}
+
+	bool ContractionHierarchy::save(char const* fileName) const
+	{
+		if (ranks.empty())
+			return false;
+
+		std::ofstream output(fileName, std::ios::binary);
+		if (!output.good())
+			return false;
+
+		output.write(HIERARCHY_FILE_TAG, sizeof(HIERARCHY_FILE_TAG));
+		output.write(reinterpret_cast<char const*>(&tileCount), sizeof(tileCount));
+		output.write(reinterpret_cast<char const*>(&checksum), sizeof(checksum));
+		output.write(reinterpret_cast<char const*>(&shortcutCount), sizeof(shortcutCount));
+		WriteVector(output, ranks);
+		WriteVector(output, firstForward);
+		WriteVector(output, forwardEdges);
+		WriteVector(output, firstBackward);
+		WriteVector(output, backwardEdges);
+
+		return output.good();
+	}
+
+	bool ContractionHierarchy::load(char const* fileName, HexGraph const& graph)
+	{
+		clear();
+
+		std::ifstream input(fileName, std::ios::binary);
+		if (!input.good())
+			return false;
+
+		char tag[sizeof(HIERARCHY_FILE_TAG)];
+		int fileTileCount = 0;
+		unsigned int fileChecksum = 0;
+		int fileShortcutCount = 0;
+
+		input.read(tag, sizeof(tag));
+		input.read(reinterpret_cast<char*>(&fileTileCount), sizeof(fileTileCount));
+		input.read(reinterpret_cast<char*>(&fileChecksum), sizeof(fileChecksum));
+		input.read(reinterpret_cast<char*>(&fileShortcutCount), sizeof(fileShortcutCount));
+
+		if (!input.good() || std::memcmp(tag, HIERARCHY_FILE_TAG, sizeof(tag)) != 0
+			|| fileTileCount != graph.getTileCount() || fileChecksum != graph.getChecksum())
+			return false;
+
+		if (!ReadVector(input, ranks) || !ReadVector(input, firstForward)
+			|| !ReadVector(input, forwardEdges) || !ReadVector(input, firstBackward)
+			|| !ReadVector(input, backwardEdges)
+			|| ranks.size() != static_cast<size_t>(fileTileCount)
+			|| firstForward.size() != ranks.size() + 1
+			|| firstBackward.size() != ranks.size() + 1)
+		{
+			clear();
+			return false;
+		}
+
+		tileCount = fileTileCount;
+		checksum = fileChecksum;
+		shortcutCount = fileShortcutCount;
+		return true;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,137 @@
+//! \file ContractionHierarchy.h
+//! \brief Defines the fullsail_ai::algorithms::ContractionHierarchy class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_CONTRACTION_HIERARCHY_H_
+#define _FULLSAIL_AI_PATH_PLANNER_CONTRACTION_HIERARCHY_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Contraction hierarchy over the passable tiles of a static map.
+	//!
+	//! Preprocessing contracts tiles one independent set at a time, least important first.
+	//! Importance is the edge difference (shortcuts added minus edges removed) plus the number
+	//! of neighbors already contracted.  Contracting a tile adds a shortcut between two of its
+	//! neighbors unless a bounded witness search finds a path at least as cheap around it.
+	//!
+	//! A query then runs two small Dijkstra searches that only climb to more important tiles,
+	//! one forward from the start and one backward from the goal, and unpacks the shortcuts
+	//! on the cheapest meeting point back into adjacent tiles.
+	class ContractionHierarchy
+	{
+	public:
+		//! \brief Per-thread scratch space for queries.
+		//!
+		//! Reusing one <code>%Query</code> across calls avoids clearing per-tile arrays, so a
+		//! query only touches the tiles it visits.
+		class Query
+		{
+			friend class ContractionHierarchy;
+
+			struct Label
+			{
+				unsigned int cost;
+				unsigned int stamp;
+				int parent;
+				int parentEdge;
+			};
+
+			std::vector<Label> forward;
+			std::vector<Label> backward;
+			std::vector<std::pair<unsigned int, int> > forwardOpen;
+			std::vector<std::pair<unsigned int, int> > backwardOpen;
+			unsigned int stamp;
+			int settledCount;
+
+		public:
+			DLLEXPORT Query();
+
+			//! \brief Returns the labels the last query settled, in both directions.
+			inline int getSettledCount() const
+			{
+				return settledCount;
+			}
+		};
+
+	private:
+		struct Edge
+		{
+			int other;
+			unsigned int cost;
+			//! Contracted tile this shortcut bypasses, or -1 for a move between adjacent tiles.
+			int middle;
+		};
+
+		// Rank of each tile in the contraction order, -1 for impassable tiles
+		std::vector<int> ranks;
+		// Edges to more important tiles, grouped by source tile
+		std::vector<int> firstForward;
+		std::vector<Edge> forwardEdges;
+		// Edges from more important tiles, grouped by target tile
+		std::vector<int> firstBackward;
+		std::vector<Edge> backwardEdges;
+		int tileCount;
+		unsigned int checksum;
+		int shortcutCount;
+
+		unsigned int Search(int start, int goal, Query& query, int& meeting) const;
+		void UnpackEdge(int from, int to, int middle, std::vector<int>& tiles) const;
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT ContractionHierarchy();
+
+		//! \brief Contracts every passable tile of the graph.
+		//!
+		//! \param   graph        the graph to preprocess.
+		//! \param   threadCount  the number of threads, or 0 to use every hardware thread.
+		DLLEXPORT void build(HexGraph const& graph, unsigned int threadCount = 0);
+
+		//! \brief Releases the hierarchy.
+		DLLEXPORT void clear();
+
+		//! \brief Returns true if and only if the hierarchy was built for the specified graph.
+		inline bool isValidFor(HexGraph const& graph) const
+		{
+			return !ranks.empty() && tileCount == graph.getTileCount()
+				&& checksum == graph.getChecksum();
+		}
+
+		//! \brief Returns the number of shortcuts added during preprocessing.
+		inline int getShortcutCount() const
+		{
+			return shortcutCount;
+		}
+
+		//! \brief Returns the cost of the cheapest path between two tiles, or
+		//! <code>HexGraph::INFINITE_COST</code> if there is none.
+		DLLEXPORT unsigned int findCost(int start, int goal, Query& query) const;
+
+		//! \brief Finds the cheapest path between two tiles.
+		//!
+		//! \param   graph  the graph the hierarchy was built for.
+		//! \param   start  index of the start tile.
+		//! \param   goal   index of the goal tile.
+		//! \param   path   receives the tiles ordered like
+		//!                 <code>PathSearch::getSolution()</code>: goal first, start last.
+		//!                 Left empty if the goal cannot be reached.
+		//! \param   query  scratch space owned by the calling thread.
+		//! \return  the cost of the path, or <code>HexGraph::INFINITE_COST</code>.
+		DLLEXPORT unsigned int findPath(HexGraph const& graph, int start, int goal,
+			std::vector<Tile const*>& path, Query& query) const;
+
+		//! \brief Writes the hierarchy to a binary file.
+		//!
+		//! \return  true if the file was written.
+		DLLEXPORT bool save(char const* fileName) const;
+
+		//! \brief Reads a hierarchy written by <code>save()</code>.
+		//!
+		//! \return  true if the hierarchy was loaded and matches the graph.
+		DLLEXPORT bool load(char const* fileName, HexGraph const& graph);
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_CONTRACTION_HIERARCHY_H_
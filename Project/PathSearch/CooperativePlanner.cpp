@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <functional>
+#include "CooperativePlanner.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	const int ReservationTable::NO_AGENT;
+
+	void ReservationTable::clear()
+	{
+		entries.clear();
+	}
+
+	bool ReservationTable::reserve(int tile, int time, int agent)
+	{
+		bool added;
+		int& holder = entries.insert(makeKey(tile, time), added);
+		if (added)
+			holder = agent;
+		return holder == agent;
+	}
+
+	CooperativePlanner::CooperativePlanner()
+		: graph(0), window(0), time(0), firstAgent(0), conflictCount(0)
+	{
+	}
+
+	void CooperativePlanner::initialize(HexGraph const& _graph, int _window)
+	{
+		graph = &_graph;
+		window = _window > 0 ? _window : 1;
+		clearAgents();
+	}
+
+	int CooperativePlanner::addAgent(int start, int goal)
+	{
+		Agent agent;
+		agent.position = start;
+		agent.goal = goal;
+		agent.plan.push_back(start);
+		agent.trajectory.push_back(start);
+		agent.conflicted = false;
+		agents.push_back(agent);
+		return static_cast<int>(agents.size()) - 1;
+	}
+
+	void CooperativePlanner::clearAgents()
+	{
+		agents.clear();
+		fields.clear();
+		reservations.clear();
+		time = 0;
+		firstAgent = 0;
+		conflictCount = 0;
+	}
+
+	FlowField const& CooperativePlanner::GetField(int goal)
+	{
+		FlowField& field = fields[goal];
+		if (!field.isValidFor(*graph))
+			field.build(*graph, goal);
+		return field;
+	}
+
+	bool CooperativePlanner::IsBlocked(int agent, int from, int to, int step) const
+	{
+		int holder = reservations.getAgent(to, time + step + 1);
+		if (holder != ReservationTable::NO_AGENT && holder != agent)
+			return true;
+
+		// Two agents may not swap tiles through each other
+		if (from != to)
+		{
+			int incoming = reservations.getAgent(to, time + step);
+			if (incoming != ReservationTable::NO_AGENT && incoming != agent
+				&& reservations.getAgent(from, time + step + 1) == incoming)
+				return true;
+		}
+
+		return false;
+	}
+
+	bool CooperativePlanner::PlanAgent(int agent)
+	{
+		Agent& current = agents[agent];
+		FlowField const& field = GetField(current.goal);
+
+		// Tiles that cannot reach the goal estimate zero, so the agent can still dodge
+		auto estimate = [&](int tile) -> unsigned int
+		{
+			return field.isReached(tile) ? field.getCost(tile) : 0;
+		};
+
+		// States are keyed by timestep in the high half and tile in the low half
+		typedef std::pair<unsigned int, unsigned long long> Entry;
+		std::greater<Entry> later;
+		labels.clear();
+		open.clear();
+
+		bool added;
+		unsigned long long startState = ReservationTable::makeKey(current.position, 0);
+		Label& startLabel = labels.insert(startState, added);
+		startLabel.cost = 0;
+		startLabel.parent = -1;
+		open.push_back(Entry(estimate(current.position), startState));
+
+		int last = -1;
+		while (!open.empty())
+		{
+			std::pop_heap(open.begin(), open.end(), later);
+			unsigned long long state = open.back().second;
+			unsigned int estimated = open.back().first;
+			open.pop_back();
+
+			int step = static_cast<int>(state >> 32);
+			int tile = static_cast<int>(state & 0xFFFFFFFFu);
+			unsigned int const given = labels.find(state)->cost;
+			if (estimated != given + estimate(tile))
+				continue;
+
+			if (step == window)
+			{
+				last = tile;
+				break;
+			}
+
+			// Waiting costs a step on the same tile, except on the goal
+			for (int d = -1; d < HexGraph::DIRECTION_COUNT; ++d)
+			{
+				int next = d < 0 ? tile : graph->getNeighbor(tile, d);
+				if (next < 0 || IsBlocked(agent, tile, next, step))
+					continue;
+
+				unsigned int cost = given
+					+ (d < 0 && tile == current.goal ? 0 : graph->getWeight(next));
+				unsigned long long nextState = ReservationTable::makeKey(next, step + 1);
+				Label& nextLabel = labels.insert(nextState, added);
+				if (added || cost < nextLabel.cost)
+				{
+					nextLabel.cost = cost;
+					nextLabel.parent = tile;
+					open.push_back(Entry(cost + estimate(next), nextState));
+					std::push_heap(open.begin(), open.end(), later);
+				}
+			}
+		}
+
+		current.plan.assign(window + 1, current.position);
+		for (int step = window, tile = last; tile >= 0; --step)
+		{
+			current.plan[step] = tile;
+			tile = labels.find(ReservationTable::makeKey(tile, step))->parent;
+		}
+
+		// Boxed in: wait, even if that collides, rather than leave the agent without a plan
+		bool free = true;
+		for (int step = 0; step <= window; ++step)
+		{
+			if (!reservations.reserve(current.plan[step], time + step, agent))
+				free = false;
+		}
+		return free;
+	}
+
+	bool CooperativePlanner::planWindow()
+	{
+		reservations.clear();
+		int const count = getAgentCount();
+		if (count == 0)
+			return true;
+
+		// Every agent holds its current tile before anyone moves
+		for (int a = 0; a < count; ++a)
+			reservations.reserve(agents[a].position, time, a);
+
+		bool free = true;
+		for (int i = 0; i < count; ++i)
+		{
+			int agent = (firstAgent + i) % count;
+			agents[agent].conflicted = !PlanAgent(agent);
+			if (agents[agent].conflicted)
+			{
+				++conflictCount;
+				free = false;
+			}
+		}
+
+		firstAgent = (firstAgent + 1) % count;
+		return free;
+	}
+
+	void CooperativePlanner::advance(int steps)
+	{
+		if (steps > window)
+			steps = window;
+
+		for (size_t a = 0; a < agents.size(); ++a)
+		{
+			Agent& agent = agents[a];
+			int planned = static_cast<int>(agent.plan.size()) - 1;
+			for (int step = 1; step <= steps; ++step)
+				agent.trajectory.push_back(agent.plan[step <= planned ? step : planned]);
+
+			agent.position = agent.trajectory.back();
+			agent.plan.assign(1, agent.position);
+		}
+
+		time += steps;
+	}
+
+	bool CooperativePlanner::solve(int stepsPerWindow, int maxSteps)
+	{
+		if (stepsPerWindow < 1)
+			stepsPerWindow = 1;
+
+		bool free = true;
+		while (time < maxSteps)
+		{
+			bool arrived = true;
+			for (int a = 0; a < getAgentCount() && arrived; ++a)
+				arrived = isAtGoal(a);
+			if (arrived)
+				return free;
+
+			if (!planWindow())
+				free = false;
+			advance(stepsPerWindow);
+		}
+
+		for (int a = 0; a < getAgentCount(); ++a)
+		{
+			if (!isAtGoal(a))
+				return false;
+		}
+		return free;
+	}
+}}  // namespace fullsail_ai::algorithms
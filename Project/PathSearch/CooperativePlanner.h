@@ -0,0 +1,190 @@
+//! \file CooperativePlanner.h
+//! \brief Defines the fullsail_ai::algorithms::ReservationTable and
+//! fullsail_ai::algorithms::CooperativePlanner class interfaces.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_COOPERATIVE_PLANNER_H_
+#define _FULLSAIL_AI_PATH_PLANNER_COOPERATIVE_PLANNER_H_
+
+#include <unordered_map>
+#include <vector>
+#include "HexGraph.h"
+#include "FlowField.h"
+#include "StampedHashTable.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Which agent occupies a tile at a timestep.
+	//!
+	//! A <code>StampedHashTable</code> keyed by (tile, timestep), so <code>clear()</code>
+	//! runs in constant time and the table is reused without touching its memory.
+	class ReservationTable
+	{
+		StampedHashTable<unsigned long long, int> entries;
+
+	public:
+		//! Returned by <code>getAgent()</code> for a free tile.
+		static const int NO_AGENT = -1;
+
+		//! \brief Returns the key of a tile at a timestep: timestep in the high half, tile in
+		//! the low half.
+		inline static unsigned long long makeKey(int tile, int time)
+		{
+			return (static_cast<unsigned long long>(static_cast<unsigned int>(time)) << 32)
+				| static_cast<unsigned int>(tile);
+		}
+
+		//! \brief Releases every reservation in constant time.
+		DLLEXPORT void clear();
+
+		//! \brief Reserves a tile at a timestep for an agent.
+		//!
+		//! \return  false if another agent already holds it.
+		DLLEXPORT bool reserve(int tile, int time, int agent);
+
+		//! \brief Returns the agent holding a tile at a timestep, or <code>NO_AGENT</code>.
+		inline int getAgent(int tile, int time) const
+		{
+			int const* agent = entries.find(makeKey(tile, time));
+			return agent != 0 ? *agent : NO_AGENT;
+		}
+	};
+
+	//! \brief Windowed hierarchical cooperative A* (WHCA*) for many agents.
+	//!
+	//! Agents are planned one after another through space and time.  Each agent searches
+	//! (tile, timestep) states for the next window of steps, may wait in place, and avoids
+	//! the tiles and swaps reserved by the agents planned before it; its own path is then
+	//! reserved for those after it.  The order rotates every window so no agent always yields.
+	//!
+	//! The heuristic is the true cost to the agent's goal, read from a
+	//! <code>FlowField</code> built once per goal and shared by every agent heading there.
+	//! Beyond the window that cost also stands in for the rest of the path.
+	class CooperativePlanner
+	{
+		struct Agent
+		{
+			int position;
+			int goal;
+			//! Tile at each timestep of the current window, starting with the position.
+			std::vector<int> plan;
+			//! Every tile occupied so far, starting with the start tile.
+			std::vector<int> trajectory;
+			//! Whether the plan collides with one reserved before it.
+			bool conflicted;
+		};
+
+		struct Label
+		{
+			unsigned int cost;
+			//! Tile at the previous timestep, or -1 at the start.
+			int parent;
+		};
+
+		HexGraph const* graph;
+		int window;
+		int time;
+		int firstAgent;
+		int conflictCount;
+		std::vector<Agent> agents;
+		std::unordered_map<int, FlowField> fields;
+		ReservationTable reservations;
+
+		// Space-time search scratch, labels keyed like the reservations
+		StampedHashTable<unsigned long long, Label> labels;
+		std::vector<std::pair<unsigned int, unsigned long long> > open;
+
+		FlowField const& GetField(int goal);
+		bool IsBlocked(int agent, int from, int to, int step) const;
+		bool PlanAgent(int agent);
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT CooperativePlanner();
+
+		//! \brief Prepares the planner for a graph and removes all agents.
+		//!
+		//! \param   _graph   the graph the agents move on; must outlive the planner's use.
+		//! \param   _window  the number of timesteps each agent plans ahead.
+		DLLEXPORT void initialize(HexGraph const& _graph, int _window = 16);
+
+		//! \brief Adds an agent.
+		//!
+		//! \return  the agent's id.
+		DLLEXPORT int addAgent(int start, int goal);
+
+		//! \brief Removes every agent and forgets the cached heuristics.
+		DLLEXPORT void clearAgents();
+
+		//! \brief Plans the next window for every agent.
+		//!
+		//! An agent boxed in by the agents planned before it waits in place, even though that
+		//! collides with one of them; <code>isConflicted()</code> tells which agents did.
+		//!
+		//! \return  true if no plan collides with another.
+		DLLEXPORT bool planWindow();
+
+		//! \brief Moves every agent along its plan.
+		//!
+		//! \param   steps  the number of timesteps to advance, at most the window.
+		DLLEXPORT void advance(int steps);
+
+		//! \brief Alternates <code>planWindow()</code> and <code>advance()</code> until every
+		//! agent stands on its goal.
+		//!
+		//! \param   stepsPerWindow  timesteps to advance per window, usually half the window.
+		//! \param   maxSteps        give up after this many timesteps.
+		//! \return  true if every agent reached its goal without any plan colliding on the
+		//!          way.
+		DLLEXPORT bool solve(int stepsPerWindow, int maxSteps);
+
+		inline int getAgentCount() const
+		{
+			return static_cast<int>(agents.size());
+		}
+
+		//! \brief Returns the current timestep.
+		inline int getTime() const
+		{
+			return time;
+		}
+
+		inline int getPosition(int agent) const
+		{
+			return agents[agent].position;
+		}
+
+		inline bool isAtGoal(int agent) const
+		{
+			return agents[agent].position == agents[agent].goal;
+		}
+
+		//! \brief Returns true if the agent's current plan collides with another agent's,
+		//! because it was boxed in and had to wait.
+		inline bool isConflicted(int agent) const
+		{
+			return agents[agent].conflicted;
+		}
+
+		//! \brief Returns the number of colliding plans since the agents were added.
+		inline int getConflictCount() const
+		{
+			return conflictCount;
+		}
+
+		//! \brief Returns the tiles of the current window, one per timestep, starting with the
+		//! agent's position.
+		inline std::vector<int> const& getPlan(int agent) const
+		{
+			return agents[agent].plan;
+		}
+
+		//! \brief Returns every tile the agent has occupied, one per timestep, starting with
+		//! its start tile.
+		inline std::vector<int> const& getTrajectory(int agent) const
+		{
+			return agents[agent].trajectory;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_COOPERATIVE_PLANNER_H_
@@ -0,0 +1,123 @@
+#include "CostOverlay.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	const unsigned int CostOverlay::BLOCKED;
+	const unsigned int CostOverlay::MAX_PENALTY;
+
+	CostOverlay::CostOverlay()
+		: count(0), maxPenalty(0)
+	{
+		Entry empty = { -1, 0 };
+		entries.assign(16, empty);
+		resetRemap();
+	}
+
+	void CostOverlay::resetRemap()
+	{
+		for (int w = 0; w < 256; ++w)
+			remap[w] = static_cast<unsigned char>(w);
+		UpdateRemapBounds();
+	}
+
+	void CostOverlay::setRemap(unsigned char const* table)
+	{
+		for (int w = 1; w < 256; ++w)
+			remap[w] = table[w];
+		UpdateRemapBounds();
+	}
+
+	void CostOverlay::setRemap(unsigned char baseWeight, unsigned char weight)
+	{
+		if (baseWeight == 0)
+			return;
+
+		remap[baseWeight] = weight;
+		UpdateRemapBounds();
+	}
+
+	void CostOverlay::UpdateRemapBounds()
+	{
+		remap[0] = 0;
+		minimumWeight = 0;
+		lowersWeights = false;
+
+		for (int w = 1; w < 256; ++w)
+		{
+			if (remap[w] == 0)
+				continue;
+			if (remap[w] < w)
+				lowersWeights = true;
+			if (minimumWeight == 0 || remap[w] < minimumWeight)
+				minimumWeight = remap[w];
+		}
+	}
+
+	void CostOverlay::Grow()
+	{
+		std::vector<Entry> old;
+		old.swap(entries);
+
+		Entry empty = { -1, 0 };
+		entries.assign(old.size() * 2, empty);
+
+		unsigned int mask = static_cast<unsigned int>(entries.size()) - 1;
+		for (int i = 0; i < static_cast<int>(old.size()); ++i)
+		{
+			if (old[i].tile < 0)
+				continue;
+
+			unsigned int slot = Slot(old[i].tile, mask);
+			while (entries[slot].tile >= 0)
+				slot = (slot + 1) & mask;
+			entries[slot] = old[i];
+		}
+	}
+
+	void CostOverlay::block(int tile)
+	{
+		addPenalty(tile, BLOCKED);
+	}
+
+	void CostOverlay::addPenalty(int tile, unsigned int penalty)
+	{
+		// Keep probes short: at most half full
+		if ((count + 1) * 2 > static_cast<int>(entries.size()))
+			Grow();
+
+		unsigned int mask = static_cast<unsigned int>(entries.size()) - 1;
+		unsigned int slot = Slot(tile, mask);
+		while (entries[slot].tile >= 0 && entries[slot].tile != tile)
+			slot = (slot + 1) & mask;
+
+		Entry& entry = entries[slot];
+		if (entry.tile < 0)
+		{
+			entry.tile = tile;
+			entry.penalty = 0;
+			++count;
+		}
+
+		// A blocked tile stays blocked; other penalties saturate
+		if (penalty == BLOCKED || entry.penalty == BLOCKED)
+			entry.penalty = BLOCKED;
+		else if (penalty >= MAX_PENALTY - entry.penalty)
+			entry.penalty = MAX_PENALTY;
+		else
+			entry.penalty += penalty;
+
+		if (entry.penalty != BLOCKED && entry.penalty > maxPenalty)
+			maxPenalty = entry.penalty;
+	}
+
+	void CostOverlay::clearTiles()
+	{
+		if (count == 0)
+			return;
+
+		Entry empty = { -1, 0 };
+		entries.assign(entries.size(), empty);
+		count = 0;
+		maxPenalty = 0;
+	}
+}}  // namespace fullsail_ai::algorithms
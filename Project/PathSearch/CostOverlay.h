@@ -0,0 +1,141 @@
+//! \file CostOverlay.h
+//! \brief Defines the fullsail_ai::algorithms::CostOverlay class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_COST_OVERLAY_H_
+#define _FULLSAIL_AI_PATH_PLANNER_COST_OVERLAY_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Changes the cost of moving onto tiles for one query, leaving the map untouched.
+	//!
+	//! Two layers are applied on top of the base weight:
+	//! - a 256-entry remap table, one per unit class, that replaces each base weight with
+	//!   another; a zero entry makes that terrain impassable;
+	//! - a sparse set of tiles, keyed by index, that are blocked outright or cost a penalty on
+	//!   top, such as tiles occupied by other units.
+	//!
+	//! The remap is one table lookup per step and the sparse set is skipped while it is
+	//! empty, so an overlay adds next to nothing to an expansion.
+	class CostOverlay
+	{
+		struct Entry
+		{
+			int tile;
+			unsigned int penalty;
+		};
+
+		unsigned char remap[256];
+		unsigned char minimumWeight;
+		bool lowersWeights;
+
+		// Open-addressing set of tiles with a penalty; tile -1 marks a free slot
+		std::vector<Entry> entries;
+		int count;
+		unsigned int maxPenalty;
+
+		inline static unsigned int Slot(int tile, unsigned int mask)
+		{
+			return (static_cast<unsigned int>(tile) * 2654435761u) & mask;
+		}
+
+		void UpdateRemapBounds();
+		void Grow();
+
+	public:
+		//! Penalty that makes a tile impassable.
+		static const unsigned int BLOCKED = HexGraph::INFINITE_COST;
+
+		//! Penalties add up to at most this, so path costs cannot wrap around.
+		static const unsigned int MAX_PENALTY = 0x00FFFFFFu;
+
+		//! \brief Creates an overlay that changes nothing.
+		DLLEXPORT CostOverlay();
+
+		//! \brief Restores the identity remap.
+		DLLEXPORT void resetRemap();
+
+		//! \brief Replaces the remap table.
+		//!
+		//! \param   table  256 weights indexed by base weight; entry 0 is ignored, as walls
+		//!                 stay walls.
+		DLLEXPORT void setRemap(unsigned char const* table);
+
+		//! \brief Sets the weight that replaces one base weight.
+		DLLEXPORT void setRemap(unsigned char baseWeight, unsigned char weight);
+
+		//! \brief Makes a tile impassable for this query.
+		DLLEXPORT void block(int tile);
+
+		//! \brief Adds to the cost of moving onto a tile for this query.
+		DLLEXPORT void addPenalty(int tile, unsigned int penalty);
+
+		//! \brief Removes every blocked tile and penalty, keeping the remap.
+		DLLEXPORT void clearTiles();
+
+		//! \brief Returns true if the remap makes some terrain cheaper than its base weight.
+		//!
+		//! Heuristics precomputed on base weights, such as <code>LandmarkTable</code>,
+		//! overestimate such an overlay and must not be used with it.
+		inline bool isLoweringWeights() const
+		{
+			return lowersWeights;
+		}
+
+		//! \brief Returns the lowest remapped weight of any passable terrain, for scaling
+		//! distance heuristics.
+		inline unsigned char getMinimumWeight() const
+		{
+			return minimumWeight;
+		}
+
+		//! \brief Returns the largest penalty on a tile that is not blocked, which bounds the
+		//! cost of a single step together with the remap.
+		inline unsigned int getMaxPenalty() const
+		{
+			return maxPenalty;
+		}
+
+		//! \brief Returns the penalty on a tile, <code>BLOCKED</code>, or zero.
+		inline unsigned int getPenalty(int tile) const
+		{
+			if (count == 0)
+				return 0;
+
+			unsigned int mask = static_cast<unsigned int>(entries.size()) - 1;
+			for (unsigned int slot = Slot(tile, mask); entries[slot].tile >= 0;
+				slot = (slot + 1) & mask)
+			{
+				if (entries[slot].tile == tile)
+					return entries[slot].penalty;
+			}
+
+			return 0;
+		}
+
+		//! \brief Returns the cost of moving onto a tile, or
+		//! <code>HexGraph::INFINITE_COST</code> if the overlay makes it impassable.
+		//!
+		//! \param   tile        index of the tile.
+		//! \param   baseWeight  the tile's weight in the map; must not be zero.
+		inline unsigned int getCost(int tile, unsigned char baseWeight) const
+		{
+			unsigned int weight = remap[baseWeight];
+			if (weight == 0)
+				return HexGraph::INFINITE_COST;
+
+			unsigned int penalty = getPenalty(tile);
+			return penalty == BLOCKED ? HexGraph::INFINITE_COST : weight + penalty;
+		}
+
+		//! \brief Returns the cost of moving onto a passable tile of the graph.
+		inline unsigned int getCost(HexGraph const& graph, int tile) const
+		{
+			return getCost(tile, graph.getWeight(tile));
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_COST_OVERLAY_H_
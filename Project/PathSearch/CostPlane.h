@@ -0,0 +1,86 @@
+//! \file CostPlane.h
+//! \brief Defines the fullsail_ai::algorithms::computeCostPlane function template and the
+//! fullsail_ai::algorithms::LinearChannelCost cost function.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_COST_PLANE_H_
+#define _FULLSAIL_AI_PATH_PLANNER_COST_PLANE_H_
+
+#include <vector>
+#include "../TileSystem/TileMap.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Computes one step cost per tile for a unit class.
+	//!
+	//! The cost function is a template parameter, so each unit class gets its own compiled
+	//! loop with the function inlined.  It runs once per map; searches then read the plane,
+	//! usually through <code>HexGraph::build(TileMap const*, unsigned char const*)</code>,
+	//! instead of combining channels on every expansion.
+	//!
+	//! \param   tileMap  the map, with or without attribute channels.
+	//! \param   cost     called as <code>cost(weight, attributes)</code> for every passable
+	//!                   tile, where <code>attributes</code> points to the tile's channels
+	//!                   or is <code>NULL</code>; returns the step cost, zero for impassable.
+	//! \param   plane    receives one cost per tile in row-major order; walls stay zero.
+	template <class CostFunction>
+	void computeCostPlane(TileMap const& tileMap, CostFunction const& cost,
+		std::vector<unsigned char>& plane)
+	{
+		int const rows = tileMap.getRowCount();
+		int const columns = tileMap.getColumnCount();
+		plane.assign(rows * columns, 0);
+
+		for (int row = 0; row < rows; ++row)
+		{
+			for (int column = 0; column < columns; ++column)
+			{
+				unsigned char weight = tileMap.getTile(row, column)->getWeight();
+				if (weight != 0)
+					plane[row * columns + column] = cost(weight, tileMap.getAttributes(row, column));
+			}
+		}
+	}
+
+	//! \brief Cost function for a unit class that scales the base weight and adds weighted
+	//! channels, such as an elevation or hazard penalty.
+	//!
+	//! <code>cost = weight * baseScale + sum(attribute[c] * channelScales[c])</code>, clamped
+	//! to 1..255.  A tile whose blocking channel reaches the threshold is impassable, such as
+	//! deep water for ground units.
+	//!
+	//! \tparam  CHANNEL_COUNT  the number of channels the function reads; the map must have
+	//!                        at least that many.
+	template <int CHANNEL_COUNT>
+	struct LinearChannelCost
+	{
+		int baseScale;
+		int channelScales[CHANNEL_COUNT];
+		//! Channel that makes tiles impassable, or -1.
+		int blockingChannel;
+		int blockingThreshold;
+
+		LinearChannelCost()
+			: baseScale(1), blockingChannel(-1), blockingThreshold(256)
+		{
+			for (int c = 0; c < CHANNEL_COUNT; ++c)
+				channelScales[c] = 0;
+		}
+
+		inline unsigned char operator()(unsigned char weight, unsigned char const* attributes) const
+		{
+			int total = weight * baseScale;
+
+			if (attributes != 0)
+			{
+				if (blockingChannel >= 0 && attributes[blockingChannel] >= blockingThreshold)
+					return 0;
+
+				for (int c = 0; c < CHANNEL_COUNT; ++c)
+					total += attributes[c] * channelScales[c];
+			}
+
+			return static_cast<unsigned char>(total < 1 ? 1 : total > 255 ? 255 : total);
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_COST_PLANE_H_
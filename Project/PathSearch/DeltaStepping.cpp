@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "DeltaStepping.h"
+#include "Parallel.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		// Frontier entries claimed at a time by one thread
+		unsigned int const CHUNK_SIZE = 256;
+
+		// Bucket index meaning no bucket is left
+		unsigned int const NO_BUCKET = 0xFFFFFFFFu;
+
+		struct Item
+		{
+			int tile;
+			unsigned int cost;
+		};
+
+		// Buckets and work lists of one thread, padded so that threads do not share a
+		// cache line
+		struct alignas(64) Worker
+		{
+			std::vector<std::vector<Item> > buckets;
+			std::vector<Item> frontier;
+			std::vector<Item> settled;
+			unsigned int relaxationCount;
+		};
+
+		struct alignas(64) Slot
+		{
+			unsigned int value;
+		};
+
+		// Lowers an atomic cost to the value if that is cheaper.  Returns true if it did.
+		inline bool LowerCost(std::atomic<unsigned int>& cost, unsigned int value)
+		{
+			unsigned int current = cost.load(std::memory_order_relaxed);
+			while (value < current)
+			{
+				if (cost.compare_exchange_weak(current, value, std::memory_order_relaxed))
+					return true;
+			}
+
+			return false;
+		}
+	}
+
+	DeltaStepping::DeltaStepping()
+		: requestedDelta(0), delta(0), bucketCount(0), lightPhaseCount(0), relaxationCount(0)
+	{
+	}
+
+	void DeltaStepping::setDelta(unsigned int _delta)
+	{
+		requestedDelta = _delta;
+	}
+
+	unsigned int DeltaStepping::getDefaultDelta(HexGraph const& graph)
+	{
+		// Twice the mean weight of the passable tiles
+		unsigned char const* weights = graph.getWeights();
+		unsigned long long total = 0;
+		unsigned int passable = 0;
+		for (int i = 0; i < graph.getTileCount(); ++i)
+		{
+			total += weights[i];
+			passable += weights[i] != 0;
+		}
+
+		return passable != 0 ? static_cast<unsigned int>((total * 2 + passable - 1) / passable) : 1;
+	}
+
+	void DeltaStepping::computeCosts(HexGraph const& graph, int source,
+		std::vector<unsigned int>& costs, bool towardSource, unsigned int maxCost,
+		unsigned int threadCount)
+	{
+		int const tiles = graph.getTileCount();
+		unsigned char const* weights = graph.getWeights();
+
+		if (threadCount == 0)
+			threadCount = getDefaultThreadCount();
+		delta = requestedDelta != 0 ? requestedDelta : getDefaultDelta(graph);
+		bucketCount = lightPhaseCount = relaxationCount = 0;
+
+		costs.assign(tiles, HexGraph::INFINITE_COST);
+		if (towardSource && !graph.isPassable(source))
+			return;
+
+		unsigned int heaviest = 0;
+		for (int i = 0; i < tiles; ++i)
+			heaviest = weights[i] > heaviest ? weights[i] : heaviest;
+
+		// Every pending cost lies within one step of the bucket being emptied
+		unsigned int const ringSize = heaviest / delta + 2;
+
+		std::unique_ptr<std::atomic<unsigned int>[]> field(new std::atomic<unsigned int>[tiles]);
+		std::vector<Worker> workers(threadCount);
+		// Values each thread publishes to the others, double-buffered by round parity
+		std::vector<Slot> slots(threadCount * 2);
+		std::atomic<unsigned int> claims[2];
+		claims[0] = claims[1] = 0;
+		SpinBarrier barrier(threadCount);
+
+		auto run = [&](unsigned int self)
+		{
+			Worker& me = workers[self];
+			me.buckets.resize(ringSize);
+			me.relaxationCount = 0;
+
+			int const sliceBegin = static_cast<int>(static_cast<long long>(tiles) * self / threadCount);
+			int const sliceEnd = static_cast<int>(static_cast<long long>(tiles) * (self + 1) / threadCount);
+			for (int i = sliceBegin; i < sliceEnd; ++i)
+				field[i].store(HexGraph::INFINITE_COST, std::memory_order_relaxed);
+			barrier.wait();
+
+			if (self == 0)
+			{
+				field[source].store(0, std::memory_order_relaxed);
+				Item item = { source, 0 };
+				me.buckets[0].push_back(item);
+			}
+
+			// Relaxes the light or the heavy moves out of a tile
+			auto relax = [&](Item const& item, bool light)
+			{
+				unsigned int leaving = weights[item.tile];
+				if (towardSource && (leaving <= delta) != light)
+					return;
+
+				for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+				{
+					int neighbor = graph.getNeighbor(item.tile, d);
+					if (neighbor < 0)
+						continue;
+
+					unsigned int weight = towardSource ? leaving : weights[neighbor];
+					if (!towardSource && (weight <= delta) != light)
+						continue;
+
+					unsigned int cost = item.cost + weight;
+					if (cost > maxCost)
+						continue;
+
+					++me.relaxationCount;
+					if (LowerCost(field[neighbor], cost))
+					{
+						Item lowered = { neighbor, cost };
+						me.buckets[(cost / delta) % ringSize].push_back(lowered);
+					}
+				}
+			};
+
+			// Publishes a value, waits for every thread to do the same, and returns the
+			// published values of the round
+			unsigned int round = 0;
+			auto publish = [&](unsigned int value) -> Slot const*
+			{
+				Slot const* published = &slots[(round & 1) * threadCount];
+				slots[(round & 1) * threadCount + self].value = value;
+				barrier.wait();
+
+				// The other parity's claim counter was last used before this barrier and is
+				// next used after the following one
+				if (self == 0)
+					claims[(round + 1) & 1].store(0, std::memory_order_relaxed);
+
+				++round;
+				return published;
+			};
+
+			for (unsigned int current = 0; ; )
+			{
+				unsigned int lowest = NO_BUCKET;
+				for (unsigned int k = 0; k < ringSize && lowest == NO_BUCKET; ++k)
+				{
+					if (!me.buckets[(current + k) % ringSize].empty())
+						lowest = current + k;
+				}
+
+				Slot const* lowests = publish(lowest);
+				current = NO_BUCKET;
+				for (unsigned int t = 0; t < threadCount; ++t)
+					current = lowests[t].value < current ? lowests[t].value : current;
+				if (current == NO_BUCKET)
+					break;
+
+				if (self == 0)
+					++bucketCount;
+
+				// Light phases: empty the bucket until no light move refills it
+				std::vector<Item>& bucket = me.buckets[current % ringSize];
+				for (;;)
+				{
+					me.frontier.swap(bucket);
+					bucket.clear();
+
+					std::atomic<unsigned int>& claim = claims[round & 1];
+					Slot const* sizes = publish(static_cast<unsigned int>(me.frontier.size()));
+					unsigned int total = 0;
+					for (unsigned int t = 0; t < threadCount; ++t)
+						total += sizes[t].value;
+					if (total == 0)
+						break;
+
+					if (self == 0)
+						++lightPhaseCount;
+
+					for (unsigned int begin = claim.fetch_add(CHUNK_SIZE); begin < total;
+						begin = claim.fetch_add(CHUNK_SIZE))
+					{
+						unsigned int end = begin + CHUNK_SIZE < total ? begin + CHUNK_SIZE : total;
+
+						// Frontiers are numbered thread after thread
+						unsigned int owner = 0;
+						unsigned int base = 0;
+						for (unsigned int i = begin; i < end; ++i)
+						{
+							while (i - base >= sizes[owner].value)
+								base += sizes[owner++].value;
+
+							Item const& item = workers[owner].frontier[i - base];
+
+							// Skip entries left behind by cheaper arrivals
+							if (field[item.tile].load(std::memory_order_relaxed) != item.cost)
+								continue;
+
+							me.settled.push_back(item);
+							relax(item, true);
+						}
+					}
+
+					barrier.wait();
+				}
+
+				// Heavy moves land in later buckets, so each settled tile relaxes them once
+				for (int i = 0; i < static_cast<int>(me.settled.size()); ++i)
+				{
+					Item const& item = me.settled[i];
+					if (field[item.tile].load(std::memory_order_relaxed) == item.cost)
+						relax(item, false);
+				}
+				me.settled.clear();
+				++current;
+			}
+
+			for (int i = sliceBegin; i < sliceEnd; ++i)
+				costs[i] = field[i].load(std::memory_order_relaxed);
+		};
+
+		std::vector<std::thread> threads;
+		for (unsigned int t = 1; t < threadCount; ++t)
+			threads.push_back(std::thread(run, t));
+		run(0);
+		for (int t = 0; t < static_cast<int>(threads.size()); ++t)
+			threads[t].join();
+
+		for (unsigned int t = 0; t < threadCount; ++t)
+			relaxationCount += workers[t].relaxationCount;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,89 @@
+//! \file DeltaStepping.h
+//! \brief Defines the fullsail_ai::algorithms::DeltaStepping class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_DELTA_STEPPING_H_
+#define _FULLSAIL_AI_PATH_PLANNER_DELTA_STEPPING_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Full-map distance fields computed by several threads at once with
+	//! delta-stepping.
+	//!
+	//! Tiles wait in buckets of costs <code>delta</code> wide instead of a priority queue.
+	//! The lowest bucket is emptied by all threads together, each taking chunks of it; moves
+	//! costing at most <code>delta</code> (light moves) can land back in the same bucket, so
+	//! it is emptied again until it stays empty.  Only then are the heavier moves out of the
+	//! tiles it settled relaxed, once, since they always land in later buckets.  A small
+	//! delta wastes no work but syncs the threads often; a large one syncs rarely but
+	//! relaxes tiles that are lowered again later.
+	//!
+	//! Costs live in one packed array of 32-bit atomics, lowered with compare-and-swap, so
+	//! threads relax any tile without locks.  Each thread files the tiles it lowers in its
+	//! own buckets; no step costs more than the heaviest weight, so a ring of
+	//! <code>heaviest / delta + 2</code> buckets per thread is enough.  The results match
+	//! <code>HexGraph::computeCosts()</code>.
+	class DeltaStepping
+	{
+		unsigned int requestedDelta;
+		unsigned int delta;
+		unsigned int bucketCount;
+		unsigned int lightPhaseCount;
+		unsigned int relaxationCount;
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT DeltaStepping();
+
+		//! \brief Sets the bucket width, or 0 to pick one from the weights of the graph.
+		DLLEXPORT void setDelta(unsigned int _delta);
+
+		//! \brief Returns the bucket width <code>setDelta(0)</code> picks for the graph.
+		DLLEXPORT static unsigned int getDefaultDelta(HexGraph const& graph);
+
+		//! \brief Computes the cost of the cheapest path between the source and every tile.
+		//!
+		//! \param   graph        the graph to search.
+		//! \param   source       index of the tile to start from, or to reach.
+		//! \param   costs        receives one cost per tile, <code>HexGraph::INFINITE_COST</code>
+		//!                       if the tile was not reached.
+		//! \param   towardSource false for the cost from the source to each tile, as
+		//!                       <code>HexGraph::computeCosts()</code> gives; true for the
+		//!                       cost from each tile to the source, as a flow field needs.
+		//! \param   maxCost      tiles costing more than this are left unreached.
+		//! \param   threadCount  the number of threads, or 0 to use every hardware thread.
+		DLLEXPORT void computeCosts(HexGraph const& graph, int source,
+			std::vector<unsigned int>& costs, bool towardSource = false,
+			unsigned int maxCost = HexGraph::INFINITE_COST, unsigned int threadCount = 0);
+
+		//! \brief Returns the bucket width of the last computation.
+		inline unsigned int getDelta() const
+		{
+			return delta;
+		}
+
+		//! \brief Returns the number of buckets the last computation emptied.
+		inline unsigned int getBucketCount() const
+		{
+			return bucketCount;
+		}
+
+		//! \brief Returns the number of times the last computation emptied a bucket, counting
+		//! every refill by light moves; each costs the threads two syncs.
+		inline unsigned int getLightPhaseCount() const
+		{
+			return lightPhaseCount;
+		}
+
+		//! \brief Returns the number of moves the last computation relaxed, a measure of its
+		//! work; Dijkstra relaxes each move out of a reached tile once.
+		inline unsigned int getRelaxationCount() const
+		{
+			return relaxationCount;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_DELTA_STEPPING_H_
@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <functional>
+#include "DistanceMatrix.h"
+#include "Parallel.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	const unsigned char DistanceMatrix::NO_MOVE;
+
+	namespace
+	{
+		// Per-thread search state, reset through the touched list so that a search costs
+		// time in proportion to the tiles it reaches
+		struct SearchScratch
+		{
+			typedef std::pair<unsigned int, int> Entry;
+
+			std::vector<unsigned int> costs;
+			std::vector<unsigned char> firstMoves;
+			std::vector<int> touched;
+			// Target tiles the current row waits for, when it needs only some
+			std::vector<bool> wanted;
+			// Move onto each reached tile, and whether it is on a path kept for a target
+			std::vector<unsigned char> parents;
+			std::vector<bool> kept;
+			// Binary heap, cheapest on top; kept as a vector so its capacity is reused
+			std::vector<Entry> open;
+		};
+	}
+
+	DistanceMatrix::DistanceMatrix()
+		: sourceCount(0), targetCount(0), settledCount(0)
+	{
+	}
+
+	void DistanceMatrix::compute(HexGraph const& graph, std::vector<int> const& _sources,
+		std::vector<int> const& _targets, bool withPaths, unsigned int threadCount)
+	{
+		Compute(graph, _sources, _targets, 0, withPaths, threadCount);
+	}
+
+	void DistanceMatrix::compute(HexGraph const& graph, std::vector<int> const& _sources,
+		std::vector<int> const& _targets, std::vector<std::vector<int> > const& wanted,
+		bool withPaths, unsigned int threadCount)
+	{
+		Compute(graph, _sources, _targets, &wanted, withPaths, threadCount);
+	}
+
+	void DistanceMatrix::Compute(HexGraph const& graph, std::vector<int> const& _sources,
+		std::vector<int> const& _targets, std::vector<std::vector<int> > const* wanted,
+		bool withPaths, unsigned int threadCount)
+	{
+		clear();
+
+		int const tiles = graph.getTileCount();
+		sources = _sources;
+		targets = _targets;
+		sourceCount = static_cast<int>(sources.size());
+		targetCount = static_cast<int>(targets.size());
+		costs.assign(sourceCount * targetCount, HexGraph::INFINITE_COST);
+		if (withPaths)
+		{
+			firstMoves.assign(sourceCount * targetCount, NO_MOVE);
+			pathMoves.resize(sourceCount);
+		}
+
+		// Columns of each target tile, chained for targets listed more than once
+		std::vector<int> firstColumn(tiles, -1);
+		std::vector<int> nextColumn(targetCount, -1);
+		int targetTiles = 0;
+		for (int column = targetCount - 1; column >= 0; --column)
+		{
+			int tile = targets[column];
+			if (firstColumn[tile] < 0 && graph.isPassable(tile))
+				++targetTiles;
+			nextColumn[column] = firstColumn[tile];
+			firstColumn[tile] = column;
+		}
+
+		if (threadCount == 0)
+			threadCount = getDefaultThreadCount();
+		std::vector<SearchScratch> scratch(threadCount);
+		std::vector<unsigned int> settled(sourceCount, 0);
+
+		parallelFor(sourceCount, [&](int row, unsigned int worker)
+		{
+			int source = sources[row];
+			if (!graph.isPassable(source))
+				return;
+
+			SearchScratch& search = scratch[worker];
+			if (search.costs.empty())
+			{
+				search.costs.assign(tiles, HexGraph::INFINITE_COST);
+				search.firstMoves.assign(tiles, NO_MOVE);
+			}
+			if (withPaths && search.parents.empty())
+			{
+				search.parents.assign(tiles, NO_MOVE);
+				search.kept.assign(tiles, false);
+			}
+
+			unsigned int* rowCosts = &costs[row * targetCount];
+			unsigned char* rowMoves = withPaths ? &firstMoves[row * targetCount] : 0;
+			std::vector<std::pair<int, unsigned char> >* tree = withPaths ? &pathMoves[row] : 0;
+			if (withPaths)
+				search.kept[source] = true;
+
+			search.costs[source] = 0;
+			search.firstMoves[source] = NO_MOVE;
+			search.touched.push_back(source);
+			search.open.push_back(SearchScratch::Entry(0, source));
+			int remaining = targetTiles;
+
+			if (wanted != 0)
+			{
+				if (search.wanted.empty())
+					search.wanted.assign(tiles, false);
+
+				remaining = 0;
+				std::vector<int> const& columns = (*wanted)[row];
+				for (size_t c = 0; c < columns.size(); ++c)
+				{
+					int tile = targets[columns[c]];
+					if (!search.wanted[tile] && graph.isPassable(tile))
+					{
+						search.wanted[tile] = true;
+						++remaining;
+					}
+				}
+			}
+
+			while (!search.open.empty() && remaining > 0)
+			{
+				std::pop_heap(search.open.begin(), search.open.end(),
+					std::greater<SearchScratch::Entry>());
+				SearchScratch::Entry current = search.open.back();
+				search.open.pop_back();
+
+				// Skip stale entries left behind by cheaper pushes
+				int tile = current.second;
+				if (current.first != search.costs[tile])
+					continue;
+
+				++settled[row];
+
+				if (firstColumn[tile] >= 0)
+				{
+					for (int column = firstColumn[tile]; column >= 0; column = nextColumn[column])
+					{
+						rowCosts[column] = current.first;
+						if (rowMoves != 0)
+							rowMoves[column] = search.firstMoves[tile];
+					}
+					if (wanted == 0 || search.wanted[tile])
+						--remaining;
+
+					// Settled tiles have final parents: keep the path back to the tree
+					for (int t = tile; tree != 0 && !search.kept[t];
+						t = graph.getAdjacent(t, HexGraph::DIRECTION_COUNT - 1 - search.parents[t]))
+					{
+						search.kept[t] = true;
+						tree->push_back(std::make_pair(t, search.parents[t]));
+					}
+				}
+
+				for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+				{
+					int successor = graph.getNeighbor(tile, d);
+					if (successor < 0)
+						continue;
+
+					unsigned int newCost = current.first + graph.getWeight(successor);
+					if (newCost >= search.costs[successor])
+						continue;
+
+					if (search.costs[successor] == HexGraph::INFINITE_COST)
+						search.touched.push_back(successor);
+					search.costs[successor] = newCost;
+					search.firstMoves[successor] = tile == source
+						? static_cast<unsigned char>(d) : search.firstMoves[tile];
+					if (tree != 0)
+						search.parents[successor] = static_cast<unsigned char>(d);
+					search.open.push_back(SearchScratch::Entry(newCost, successor));
+					std::push_heap(search.open.begin(), search.open.end(),
+						std::greater<SearchScratch::Entry>());
+				}
+			}
+
+			for (int i = 0; i < static_cast<int>(search.touched.size()); ++i)
+				search.costs[search.touched[i]] = HexGraph::INFINITE_COST;
+			search.touched.clear();
+			search.open.clear();
+
+			if (wanted != 0)
+			{
+				std::vector<int> const& columns = (*wanted)[row];
+				for (size_t c = 0; c < columns.size(); ++c)
+					search.wanted[targets[columns[c]]] = false;
+			}
+
+			if (tree != 0)
+			{
+				search.kept[source] = false;
+				for (size_t i = 0; i < tree->size(); ++i)
+					search.kept[(*tree)[i].first] = false;
+				std::sort(tree->begin(), tree->end());
+			}
+		}, threadCount);
+
+		for (int row = 0; row < sourceCount; ++row)
+			settledCount += settled[row];
+	}
+
+	void DistanceMatrix::clear()
+	{
+		sourceCount = targetCount = 0;
+		sources.clear();
+		targets.clear();
+		costs.clear();
+		firstMoves.clear();
+		pathMoves.clear();
+		settledCount = 0;
+	}
+
+	size_t DistanceMatrix::getPathMemoryUsage() const
+	{
+		size_t total = 0;
+		for (size_t row = 0; row < pathMoves.size(); ++row)
+			total += pathMoves[row].capacity() * sizeof(pathMoves[row][0]);
+		return total;
+	}
+
+	unsigned int DistanceMatrix::extractPath(HexGraph const& graph, int row, int column,
+		std::vector<Tile const*>& path) const
+	{
+		path.clear();
+
+		unsigned int cost = getCost(row, column);
+		if (pathMoves.empty() || cost == HexGraph::INFINITE_COST)
+			return HexGraph::INFINITE_COST;
+
+		std::vector<std::pair<int, unsigned char> > const& tree = pathMoves[row];
+		int tile = targets[column];
+		path.push_back(graph.getTile(tile));
+
+		while (tile != sources[row])
+		{
+			unsigned char move = std::lower_bound(tree.begin(), tree.end(),
+				std::make_pair(tile, static_cast<unsigned char>(0)))->second;
+			tile = graph.getAdjacent(tile, HexGraph::DIRECTION_COUNT - 1 - move);
+			path.push_back(graph.getTile(tile));
+		}
+
+		return cost;
+	}
+}}  // namespace fullsail_ai::algorithms
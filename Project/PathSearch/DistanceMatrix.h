@@ -0,0 +1,148 @@
+//! \file DistanceMatrix.h
+//! \brief Defines the fullsail_ai::algorithms::DistanceMatrix class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_DISTANCE_MATRIX_H_
+#define _FULLSAIL_AI_PATH_PLANNER_DISTANCE_MATRIX_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief The cost of the cheapest path from each of a set of sources to each of a set of
+	//! targets, such as every pair of points of interest for multi-stop routes and task
+	//! assignment.
+	//!
+	//! One Dijkstra search runs per source and stops as soon as every target is settled, so
+	//! a row costs about as much as the search to its furthest target instead of one search
+	//! per target.  Sources are spread over threads that share the read-only graph; each
+	//! writes only its own row.
+	//!
+	//! Optionally the paths are kept too: the first move toward every target, and for each
+	//! source the moves along the branches of its search tree that lead to targets, so any
+	//! path is extracted without searching again.  These cost memory in proportion to the
+	//! paths, not to the map.
+	class DistanceMatrix
+	{
+		int sourceCount;
+		int targetCount;
+		std::vector<int> sources;
+		std::vector<int> targets;
+		// Row-major, one row per source
+		std::vector<unsigned int> costs;
+		std::vector<unsigned char> firstMoves;
+		// Per source, the move onto each tile on a path to a target, sorted by tile
+		std::vector<std::vector<std::pair<int, unsigned char> > > pathMoves;
+		unsigned int settledCount;
+
+		//! \brief Fills the matrix, each row searching until its wanted columns are settled,
+		//! or every column if <code>wanted</code> is <code>NULL</code>.
+		void Compute(HexGraph const& graph, std::vector<int> const& _sources,
+			std::vector<int> const& _targets, std::vector<std::vector<int> > const* wanted,
+			bool withPaths, unsigned int threadCount);
+
+	public:
+		//! Move stored for pairs with no path, and for a target that is its own source.
+		static const unsigned char NO_MOVE = 0xFF;
+
+		//! \brief Default constructor.
+		DLLEXPORT DistanceMatrix();
+
+		//! \brief Fills the matrix.
+		//!
+		//! \param   graph        the graph to search.
+		//! \param   _sources     indices of the source tiles, one row each.
+		//! \param   _targets     indices of the target tiles, one column each; usually the
+		//!                       same list as the sources.
+		//! \param   withPaths    true to keep the search trees for
+		//!                       <code>getFirstMove()</code> and <code>extractPath()</code>.
+		//! \param   threadCount  the number of threads, or 0 to use every hardware thread.
+		DLLEXPORT void compute(HexGraph const& graph, std::vector<int> const& _sources,
+			std::vector<int> const& _targets, bool withPaths = false,
+			unsigned int threadCount = 0);
+
+		//! \brief Fills the matrix where only some columns of each row are needed, such as
+		//! the legs of a route through the targets in a given order.
+		//!
+		//! The search of each source stops once its own wanted targets are settled.  Other
+		//! cells of its row hold the cost of any target settled before then, and
+		//! <code>HexGraph::INFINITE_COST</code> otherwise.  The other parameters are those of
+		//! the full <code>compute()</code>.
+		//!
+		//! \param   wanted  for each source, the positions of the targets it needs.
+		DLLEXPORT void compute(HexGraph const& graph, std::vector<int> const& _sources,
+			std::vector<int> const& _targets, std::vector<std::vector<int> > const& wanted,
+			bool withPaths = false, unsigned int threadCount = 0);
+
+		//! \brief Releases the matrix.
+		DLLEXPORT void clear();
+
+		inline int getSourceCount() const
+		{
+			return sourceCount;
+		}
+
+		inline int getTargetCount() const
+		{
+			return targetCount;
+		}
+
+		//! \brief Returns the cost from a source to a target, or
+		//! <code>HexGraph::INFINITE_COST</code> if there is no path.
+		//!
+		//! \param   row     position of the source in the list passed to
+		//!                  <code>compute()</code>.
+		//! \param   column  position of the target in its list.
+		inline unsigned int getCost(int row, int column) const
+		{
+			return costs[row * targetCount + column];
+		}
+
+		//! \brief Returns the row-major cost matrix, <code>NULL</code> if it is empty.
+		inline unsigned int const* getCosts() const
+		{
+			return costs.empty() ? 0 : &costs[0];
+		}
+
+		//! \brief Returns true if the matrix was computed with its paths.
+		inline bool hasPaths() const
+		{
+			return !firstMoves.empty();
+		}
+
+		//! \brief Returns the direction of the first move from a source toward a target, or
+		//! -1 if there is none or the matrix has no paths.
+		inline int getFirstMove(int row, int column) const
+		{
+			if (firstMoves.empty())
+				return -1;
+
+			unsigned char move = firstMoves[row * targetCount + column];
+			return move == NO_MOVE ? -1 : move;
+		}
+
+		//! \brief Returns the total number of tiles settled by the searches, a measure of the
+		//! work <code>compute()</code> did.
+		inline unsigned int getSettledCount() const
+		{
+			return settledCount;
+		}
+
+		//! \brief Returns the bytes held by the kept paths.
+		DLLEXPORT size_t getPathMemoryUsage() const;
+
+		//! \brief Builds the path from a source to a target.
+		//!
+		//! \param   graph   the graph the matrix was computed on.
+		//! \param   row     position of the source.
+		//! \param   column  position of the target.
+		//! \param   path    receives the tiles ordered like
+		//!                  <code>PathSearch::getSolution()</code>: target first, source
+		//!                  last.  Left empty if there is no path or the matrix has no paths.
+		//! \return  the cost of the path, or <code>HexGraph::INFINITE_COST</code>.
+		DLLEXPORT unsigned int extractPath(HexGraph const& graph, int row, int column,
+			std::vector<Tile const*>& path) const;
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_DISTANCE_MATRIX_H_
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include "EarlyCommitSearch.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	EarlyCommitSearch::EarlyCommitSearch()
+		: graph(0), landmarks(0), overlay(0), weight(2), commitLength(16), committedMoves(0)
+		, prefixCost(0), quickCost(HexGraph::INFINITE_COST), cost(HexGraph::INFINITE_COST)
+		, expansionCount(0), status(NOT_FOUND)
+	{
+	}
+
+	void EarlyCommitSearch::setWeight(double _weight)
+	{
+		weight = _weight > 1 ? _weight : 1;
+	}
+
+	void EarlyCommitSearch::setCommitLength(int _commitLength)
+	{
+		commitLength = _commitLength > 1 ? _commitLength : 1;
+	}
+
+	void EarlyCommitSearch::start(HexGraph const& _graph, int start, int goal,
+		LandmarkTable const* _landmarks, CostOverlay const* _overlay)
+	{
+		graph = &_graph;
+		landmarks = _landmarks;
+		overlay = _overlay;
+
+		quick = SearchSession::create(_graph, start, goal, _landmarks, _overlay, weight);
+		refinement = SearchSession();
+		path.clear();
+		committedMoves = 0;
+		prefixCost = 0;
+		quickCost = HexGraph::INFINITE_COST;
+		cost = HexGraph::INFINITE_COST;
+		expansionCount = 0;
+		status = SEARCHING;
+	}
+
+	bool EarlyCommitSearch::resume(unsigned int budget)
+	{
+		if (status == SEARCHING)
+		{
+			unsigned int before = quick.getExpansionCount();
+			if (!quick.resume(budget))
+				return false;
+
+			// The rest of the budget goes to the refinement
+			unsigned int spent = quick.getExpansionCount() - before;
+			budget = spent < budget ? budget - spent : 0;
+			Commit();
+		}
+
+		if (status == COMMITTED && refinement.resume(budget))
+			Stitch();
+
+		return status == DONE || status == NOT_FOUND;
+	}
+
+	void EarlyCommitSearch::Commit()
+	{
+		if (quick.isFound())
+		{
+			quick.getSolution(path);
+			std::reverse(path.begin(), path.end());
+			quickCost = cost = quick.getCost();
+		}
+
+		Release(quick);
+		if (path.empty())
+		{
+			status = NOT_FOUND;
+			return;
+		}
+
+		int moves = static_cast<int>(path.size()) - 1;
+		committedMoves = (std::min)(commitLength, moves);
+		for (int i = 1; i <= committedMoves; ++i)
+		{
+			prefixCost += overlay != 0 ? overlay->getCost(*graph, path[i])
+				: graph->getWeight(path[i]);
+		}
+
+		// The whole path is committed; there is nothing left to refine
+		if (committedMoves == moves)
+		{
+			status = DONE;
+			return;
+		}
+
+		refinement = SearchSession::create(*graph, path[committedMoves], path.back(),
+			landmarks, overlay);
+		status = COMMITTED;
+	}
+
+	void EarlyCommitSearch::Stitch()
+	{
+		// Never worse than the quick path: its rest was a candidate for the refinement
+		std::vector<int> rest;
+		refinement.getSolution(rest);
+		if (refinement.isFound() && prefixCost + refinement.getCost() < cost)
+		{
+			path.resize(committedMoves + 1);
+			path.insert(path.end(), rest.rbegin() + 1, rest.rend());
+			cost = prefixCost + refinement.getCost();
+		}
+
+		Release(refinement);
+		status = DONE;
+	}
+
+	void EarlyCommitSearch::finish()
+	{
+		if (status != COMMITTED)
+			return;
+
+		Release(refinement);
+		status = DONE;
+	}
+
+	void EarlyCommitSearch::Release(SearchSession& session)
+	{
+		expansionCount += session.getExpansionCount();
+		session = SearchSession();
+	}
+
+	unsigned int EarlyCommitSearch::getExpansionCount() const
+	{
+		return expansionCount + quick.getExpansionCount() + refinement.getExpansionCount();
+	}
+
+	void EarlyCommitSearch::getSolution(std::vector<Tile const*>& tiles) const
+	{
+		tiles.clear();
+		for (std::vector<int>::const_reverse_iterator i = path.rbegin(); i != path.rend(); ++i)
+			tiles.push_back(graph->getTile(*i));
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,161 @@
+//! \file EarlyCommitSearch.h
+//! \brief Defines the fullsail_ai::algorithms::EarlyCommitSearch class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_EARLY_COMMIT_SEARCH_H_
+#define _FULLSAIL_AI_PATH_PLANNER_EARLY_COMMIT_SEARCH_H_
+
+#include <vector>
+#include "SearchSession.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief A path query that hands out its first moves long before the cheapest path is
+	//! known, so that an agent can start walking at once.
+	//!
+	//! A weighted A* search first finds a whole path costing at most <code>getWeight()</code>
+	//! times the optimal cost, which takes far fewer expansions than an optimal search.  The
+	//! first <code>getCommitLength()</code> moves of that path are committed: they never
+	//! change, and they always lie on a path within the bound.  An optimal search then runs
+	//! from the end of the committed prefix to the goal and its path is stitched on in place
+	//! of the rest of the quick one, which it never costs more than.
+	//!
+	//! Both searches are <code>SearchSession</code>s run for a budget of expansions per
+	//! <code>resume()</code>, so the refinement goes on in the background a frame at a time.
+	//! The graph, landmark table and overlay passed to <code>start()</code> must outlive the
+	//! query.
+	class EarlyCommitSearch
+	{
+	public:
+		enum Status
+		{
+			//! No path is known yet.
+			SEARCHING,
+			//! The prefix is committed and the rest of the path is being refined.
+			COMMITTED,
+			//! The path will not change any more.
+			DONE,
+			//! The goal cannot be reached.
+			NOT_FOUND
+		};
+
+	private:
+		HexGraph const* graph;
+		LandmarkTable const* landmarks;
+		CostOverlay const* overlay;
+		double weight;
+		int commitLength;
+
+		SearchSession quick;
+		SearchSession refinement;
+		// Tile indices, start first: the committed prefix, then the best known rest
+		std::vector<int> path;
+		int committedMoves;
+		unsigned int prefixCost;
+		unsigned int quickCost;
+		unsigned int cost;
+		// Expansions of the searches already released
+		unsigned int expansionCount;
+		Status status;
+
+		//! \brief Commits the prefix of the quick path and starts refining the rest.
+		void Commit();
+
+		//! \brief Replaces the rest of the quick path with the refined one.
+		void Stitch();
+
+		//! \brief Counts the expansions of a search and frees its memory.
+		void Release(SearchSession& session);
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT EarlyCommitSearch();
+
+		//! \brief Sets the weight of the quick search for subsequent queries.  The default
+		//! is 2.
+		DLLEXPORT void setWeight(double _weight);
+
+		inline double getWeight() const
+		{
+			return weight;
+		}
+
+		//! \brief Sets how many moves of the quick path subsequent queries commit.  The
+		//! default is 16.
+		//!
+		//! The refinement has until the agent walks them to finish; a longer prefix leaves
+		//! it more time but fixes more of the path to the quick one.
+		DLLEXPORT void setCommitLength(int _commitLength);
+
+		inline int getCommitLength() const
+		{
+			return commitLength;
+		}
+
+		//! \brief Starts a query, dropping the previous one.  No work is done until
+		//! <code>resume()</code>.
+		//!
+		//! \param   _graph      the graph to search.
+		//! \param   start       index of the start tile.
+		//! \param   goal        index of the goal tile.
+		//! \param   _landmarks  optional landmark table built for the graph.
+		//! \param   _overlay    optional costs for this query in place of the tile weights.
+		DLLEXPORT void start(HexGraph const& _graph, int start, int goal,
+			LandmarkTable const* _landmarks = 0, CostOverlay const* _overlay = 0);
+
+		//! \brief Runs the query for at most the specified number of expansions.
+		//!
+		//! \return  true if the query is done, with or without a path.
+		DLLEXPORT bool resume(unsigned int budget);
+
+		//! \brief Stops refining and keeps the rest of the quick path.
+		//!
+		//! Call this when the agent reaches the end of the prefix before the refinement is
+		//! done.  Does nothing before the prefix is committed.
+		DLLEXPORT void finish();
+
+		inline Status getStatus() const
+		{
+			return status;
+		}
+
+		//! \brief Returns true once the prefix can be walked.
+		inline bool hasPrefix() const
+		{
+			return status == COMMITTED || status == DONE;
+		}
+
+		//! \brief Returns the number of committed moves; the first that many moves of the
+		//! path never change.
+		inline int getCommittedMoves() const
+		{
+			return committedMoves;
+		}
+
+		//! \brief Returns the cost of the best path known, or
+		//! <code>HexGraph::INFINITE_COST</code> before there is one.
+		inline unsigned int getCost() const
+		{
+			return cost;
+		}
+
+		//! \brief Returns the cost of the path found by the quick search alone.
+		inline unsigned int getQuickCost() const
+		{
+			return quickCost;
+		}
+
+		//! \brief Returns the number of tiles expanded by both searches so far.
+		DLLEXPORT unsigned int getExpansionCount() const;
+
+		//! \brief Returns the tiles of the best path known.
+		//!
+		//! \param   tiles  receives the tiles ordered like
+		//!                 <code>PathSearch::getSolution()</code>: goal first, start last, so
+		//!                 the committed prefix is the last
+		//!                 <code>getCommittedMoves()</code> + 1 tiles.  Left empty before
+		//!                 there is a path.
+		DLLEXPORT void getSolution(std::vector<Tile const*>& tiles) const;
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_EARLY_COMMIT_SEARCH_H_
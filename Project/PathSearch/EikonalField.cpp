@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include "EikonalField.h"
+#include "Parallel.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FULLSAIL_AI_EIKONAL_SSE2
+#endif
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		float const HALF_ROOT_3 = 0.8660254f;
+
+		// Unit offsets to the adjacent tiles, in the order of the HexGraph directions, with
+		// x growing east and y growing down the rows
+		float const UNIT_X[HexGraph::DIRECTION_COUNT] = { -0.5f, 0.5f, -1.0f, 1.0f, -0.5f, 0.5f };
+		float const UNIT_Y[HexGraph::DIRECTION_COUNT] =
+		{
+			-HALF_ROOT_3, -HALF_ROOT_3, 0.0f, 0.0f, HALF_ROOT_3, HALF_ROOT_3
+		};
+
+		// The directions around a tile counterclockwise from up-right, so that each one is
+		// adjacent to the next
+		int const RING[HexGraph::DIRECTION_COUNT] = { 1, 0, 2, 4, 5, 3 };
+
+		// Cost of a tile from two of its neighbors that are adjacent to each other.  If the
+		// front crosses the triangle they form, the cost is that of a plane front through
+		// both; otherwise the front arrives along an edge from the cheaper one.  Harmless on
+		// unreached neighbors.
+		inline float SolveTriangle(float a, float b, float weight)
+		{
+			float difference = std::fabs(a - b);
+			float across = difference * 0.5f
+				+ HALF_ROOT_3 * std::sqrt((std::max)(weight * weight - difference * difference, 0.0f));
+			return (std::min)(a, b) + (difference <= weight * 0.5f ? across : weight);
+		}
+
+		// Lowers one tile of a row to the cost solved for it, or marks it unreached if it is
+		// impassable.  Returns true if its cost dropped by more than the tolerance.
+		inline bool RelaxTile(float& cost, float solved, unsigned char weight, float tolerance)
+		{
+			float best = weight ? (std::min)(cost, solved) : EikonalField::UNREACHED;
+			bool changed = cost - best > tolerance;
+			cost = best;
+			return changed;
+		}
+
+#if defined(FULLSAIL_AI_EIKONAL_SSE2)
+		// Same as RelaxTile(SolveTriangle()) for four tiles at once.  Returns a mask of the
+		// tiles whose cost dropped by more than the tolerance.
+		inline int RelaxFourTiles(float* row, float const* adjacent, unsigned char const* rowWeights,
+			__m128 tolerance)
+		{
+			int packed;
+			std::memcpy(&packed, rowWeights, sizeof(packed));
+			__m128i const zero = _mm_setzero_si128();
+			__m128i bytes = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+			__m128 weight = _mm_cvtepi32_ps(_mm_unpacklo_epi16(bytes, zero));
+
+			__m128 a = _mm_loadu_ps(adjacent);
+			__m128 b = _mm_loadu_ps(adjacent + 1);
+			__m128 difference = _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_sub_ps(a, b));
+			__m128 root = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_mul_ps(weight, weight),
+				_mm_mul_ps(difference, difference)), _mm_setzero_ps()));
+			__m128 across = _mm_add_ps(_mm_mul_ps(difference, _mm_set1_ps(0.5f)),
+				_mm_mul_ps(_mm_set1_ps(HALF_ROOT_3), root));
+			__m128 crosses = _mm_cmple_ps(difference, _mm_mul_ps(weight, _mm_set1_ps(0.5f)));
+			__m128 rise = _mm_or_ps(_mm_and_ps(crosses, across), _mm_andnot_ps(crosses, weight));
+			__m128 solved = _mm_add_ps(_mm_min_ps(a, b), rise);
+
+			__m128 cost = _mm_loadu_ps(row);
+			__m128 wall = _mm_cmpeq_ps(weight, _mm_setzero_ps());
+			__m128 best = _mm_or_ps(_mm_and_ps(wall, _mm_set1_ps(EikonalField::UNREACHED)),
+				_mm_andnot_ps(wall, _mm_min_ps(cost, solved)));
+			_mm_storeu_ps(row, best);
+
+			return _mm_movemask_ps(_mm_cmpgt_ps(_mm_sub_ps(cost, best), tolerance));
+		}
+#endif
+
+		// Solves every tile in one row from the triangles it forms with the adjacent row above
+		// or below it.  No tile depends on another of the row, so the tiles are solved four at
+		// a time where SSE2 is available.  Returns true if any cost dropped by more than the
+		// tolerance.
+		bool RelaxRowFrom(float* row, float const* adjacent, unsigned char const* rowWeights,
+			int columnCount, int shift, float tolerance)
+		{
+			bool changed = false;
+
+			// Edge columns have one adjacent tile off the map
+			int const first = shift ? 0 : 1;
+			int const last = shift ? columnCount - 1 : columnCount;
+
+			for (int c = 0; c < first; ++c)
+				changed |= RelaxTile(row[c], adjacent[c] + rowWeights[c], rowWeights[c], tolerance);
+
+			int c = first;
+#if defined(FULLSAIL_AI_EIKONAL_SSE2)
+			__m128 const wideTolerance = _mm_set1_ps(tolerance);
+			int mask = 0;
+			for (; c + 4 <= last; c += 4)
+				mask |= RelaxFourTiles(row + c, adjacent + c + shift - 1, rowWeights + c,
+					wideTolerance);
+			changed |= mask != 0;
+#endif
+			for (; c < last; ++c)
+			{
+				int left = c + shift - 1;
+				changed |= RelaxTile(row[c],
+					SolveTriangle(adjacent[left], adjacent[left + 1], rowWeights[c]),
+					rowWeights[c], tolerance);
+			}
+
+			for (c = last; c < columnCount; ++c)
+				changed |= RelaxTile(row[c], adjacent[c] + rowWeights[c], rowWeights[c], tolerance);
+
+			return changed;
+		}
+
+		// Solves every tile in one row from its left, then its right neighbor, together with
+		// the tile of the adjacent row that both touch.  The adjacent row is NULL at the map's
+		// edge.  Returns true if any cost dropped by more than the tolerance.
+		//
+		// Each tile waits on the one before it, so the square root is skipped wherever the
+		// cheaper of the two neighbors plus three quarters of the weight, a bound on the
+		// result, cannot improve the tile.
+		bool RelaxRowAlong(float* row, float const* adjacent, unsigned char const* rowWeights,
+			int columnCount, int shift, float tolerance)
+		{
+			bool changed = false;
+
+			for (int c = 1; c < columnCount; ++c)
+			{
+				float weight = rowWeights[c];
+				float other = adjacent ? adjacent[c + shift - 1] : EikonalField::UNREACHED;
+				if (weight == 0.0f || (std::min)(row[c - 1], other) + weight * 0.75f >= row[c])
+					continue;
+
+				float cost = SolveTriangle(row[c - 1], other, weight);
+				if (cost < row[c])
+				{
+					changed |= row[c] - cost > tolerance;
+					row[c] = cost;
+				}
+			}
+
+			for (int c = columnCount - 1; c-- > 0; )
+			{
+				float weight = rowWeights[c];
+				float other = adjacent ? adjacent[c + shift] : EikonalField::UNREACHED;
+				if (weight == 0.0f || (std::min)(row[c + 1], other) + weight * 0.75f >= row[c])
+					continue;
+
+				float cost = SolveTriangle(row[c + 1], other, weight);
+				if (cost < row[c])
+				{
+					changed |= row[c] - cost > tolerance;
+					row[c] = cost;
+				}
+			}
+
+			return changed;
+		}
+	}
+
+	const float EikonalField::UNREACHED = 1.0e30f;
+
+	EikonalField::EikonalField()
+		: goal(-1), checksum(0), tolerance(0.01f), maxPassCount(0), passCount(0), converged(false)
+	{
+	}
+
+	void EikonalField::setTolerance(float _tolerance)
+	{
+		tolerance = _tolerance;
+	}
+
+	void EikonalField::setMaxPassCount(int _maxPassCount)
+	{
+		maxPassCount = _maxPassCount;
+	}
+
+	void EikonalField::clear()
+	{
+		costs.clear();
+		directionsX.clear();
+		directionsY.clear();
+		goal = -1;
+		checksum = 0;
+		passCount = 0;
+		converged = false;
+	}
+
+	bool EikonalField::build(HexGraph const& graph, int _goal, unsigned int threadCount)
+	{
+		int const rows = graph.getRowCount();
+		int const columns = graph.getColumnCount();
+		int const tiles = graph.getTileCount();
+		unsigned char const* weights = graph.getWeights();
+
+		if (threadCount == 0)
+			threadCount = getDefaultThreadCount();
+
+		costs.assign(tiles, UNREACHED);
+		directionsX.assign(tiles, 0.0f);
+		directionsY.assign(tiles, 0.0f);
+		goal = _goal;
+		checksum = graph.getChecksum();
+		passCount = 0;
+		converged = true;
+
+		if (!graph.isPassable(goal))
+			return converged;
+		costs[goal] = 0.0f;
+
+		// Two bands per thread, so each half of the bands keeps every thread busy
+		int bandCount = static_cast<int>(threadCount) * 2;
+		if (bandCount > rows)
+			bandCount = rows;
+		int const bandRows = (rows + bandCount - 1) / bandCount;
+
+		float* field = &costs[0];
+		std::atomic<bool> changed(true);
+
+		// A row is only solved again once it, or the row it is solved from, has dropped by
+		// more than the tolerance since.  Stamps order the row updates across threads.
+		std::vector<unsigned int> changedAt(rows, 0);
+		std::vector<unsigned int> sweptDownAt(rows, 0);
+		std::vector<unsigned int> sweptUpAt(rows, 0);
+		std::atomic<unsigned int> clock(1);
+		changedAt[graph.getRow(goal)] = 1;
+
+		auto sweepRow = [&](int r, int adjacentRow, std::vector<unsigned int>& sweptAt) -> bool
+		{
+			bool hasAdjacent = adjacentRow >= 0 && adjacentRow < rows;
+			if (changedAt[r] <= sweptAt[r] && !(hasAdjacent && changedAt[adjacentRow] > sweptAt[r]))
+				return false;
+
+			unsigned int stamp = ++clock;
+			float* costRow = field + r * columns;
+			float const* adjacent = hasAdjacent ? field + adjacentRow * columns : 0;
+			bool rowChanged = false;
+			if (adjacent)
+				rowChanged |= RelaxRowFrom(costRow, adjacent, weights + r * columns, columns, r & 1,
+					tolerance);
+			rowChanged |= RelaxRowAlong(costRow, adjacent, weights + r * columns, columns, r & 1,
+				tolerance);
+
+			sweptAt[r] = stamp;
+			if (rowChanged)
+				changedAt[r] = stamp;
+			return rowChanged;
+		};
+
+		auto sweepBand = [&](int band)
+		{
+			int begin = band * bandRows;
+			int end = begin + bandRows < rows ? begin + bandRows : rows;
+			bool bandChanged = false;
+
+			// Downward sweep, then upward sweep
+			for (int r = begin; r < end; ++r)
+				bandChanged |= sweepRow(r, r - 1, sweptDownAt);
+			for (int r = end; r-- > begin; )
+				bandChanged |= sweepRow(r, r + 1, sweptUpAt);
+
+			if (bandChanged)
+				changed = true;
+		};
+
+		while (changed && (maxPassCount == 0 || passCount < maxPassCount))
+		{
+			changed = false;
+
+			// Even bands, then odd bands: a band only reads the edge rows of idle neighbors
+			for (int parity = 0; parity < 2; ++parity)
+			{
+				parallelFor((bandCount + 1 - parity) / 2, [&](int b, unsigned int)
+				{
+					sweepBand(b * 2 + parity);
+				}, threadCount);
+			}
+
+			++passCount;
+		}
+
+		converged = !changed;
+		ComputeDirections(graph, threadCount);
+		return converged;
+	}
+
+	void EikonalField::ComputeDirections(HexGraph const& graph, unsigned int threadCount)
+	{
+		int const columns = graph.getColumnCount();
+
+		parallelFor(graph.getRowCount(), [&](int row, unsigned int)
+		{
+			for (int tile = row * columns; tile < (row + 1) * columns; ++tile)
+			{
+				if (tile == goal || costs[tile] >= UNREACHED)
+					continue;
+
+				float const weight = graph.getWeight(tile);
+				float around[HexGraph::DIRECTION_COUNT];
+				for (int k = 0; k < HexGraph::DIRECTION_COUNT; ++k)
+				{
+					int neighbor = graph.getNeighbor(tile, RING[k]);
+					around[k] = neighbor >= 0 ? costs[neighbor] : UNREACHED;
+				}
+
+				// The triangle or edge the front arrives through
+				float best = UNREACHED;
+				int bestK = 0;
+				for (int k = 0; k < HexGraph::DIRECTION_COUNT; ++k)
+				{
+					float cost = SolveTriangle(around[k], around[(k + 1) % HexGraph::DIRECTION_COUNT],
+						weight);
+					if (cost < best)
+					{
+						best = cost;
+						bestK = k;
+					}
+				}
+
+				int a = RING[bestK];
+				int b = RING[(bestK + 1) % HexGraph::DIRECTION_COUNT];
+				float toA = around[bestK] - best;
+				float toB = around[(bestK + 1) % HexGraph::DIRECTION_COUNT] - best;
+				float x;
+				float y;
+
+				if (std::fabs(toA - toB) <= weight * 0.5f)
+				{
+					// Against the gradient of the plane through the three costs
+					float determinant = UNIT_X[a] * UNIT_Y[b] - UNIT_Y[a] * UNIT_X[b];
+					x = -(toA * UNIT_Y[b] - toB * UNIT_Y[a]) / determinant;
+					y = -(UNIT_X[a] * toB - UNIT_X[b] * toA) / determinant;
+				}
+				else
+				{
+					// Along the edge to the cheaper neighbor
+					int toward = toA < toB ? a : b;
+					x = UNIT_X[toward];
+					y = UNIT_Y[toward];
+				}
+
+				float length = std::sqrt(x * x + y * y);
+				if (length > 0.0f)
+				{
+					directionsX[tile] = x / length;
+					directionsY[tile] = y / length;
+				}
+			}
+		}, threadCount);
+	}
+
+	int EikonalField::getNextTile(HexGraph const& graph, int index) const
+	{
+		if (index == goal || costs[index] >= UNREACHED)
+			return -1;
+
+		int next = -1;
+		float best = costs[index];
+		for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+		{
+			int neighbor = graph.getNeighbor(index, d);
+			if (neighbor >= 0 && costs[neighbor] < best)
+			{
+				best = costs[neighbor];
+				next = neighbor;
+			}
+		}
+
+		return next;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,154 @@
+//! \file EikonalField.h
+//! \brief Defines the fullsail_ai::algorithms::EikonalField class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_EIKONAL_FIELD_H_
+#define _FULLSAIL_AI_PATH_PLANNER_EIKONAL_FIELD_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Smooth travel cost to a goal, and the direction to walk, for every tile at once.
+	//!
+	//! Where <code>FlowField</code> counts costs along the six directions of the grid, and so
+	//! sends agents along zig-zags and straight hex lines, this field solves the eikonal
+	//! equation over the map: the cost grows by a tile's weight per tile width travelled in
+	//! any direction.  Across open ground the costs form round fronts, and the directions
+	//! point straight at the goal or at the corner to round.  Unlike on the graph, crossing a
+	//! tile costs its own weight, so a cost counts the weight of the start tile rather than
+	//! that of the goal.
+	//!
+	//! Tile centers are one unit apart, rows <code>sqrt(3) / 2</code> apart.  Each tile's cost
+	//! is solved from the triangles it forms with pairs of adjacent neighbors (the
+	//! fast-marching update on a triangular mesh).  The solver sweeps the rows down, then up,
+	//! until a pass lowers no cost by more than the tolerance.  Each row first takes the
+	//! triangles it forms with the row just swept, four tiles at a time with SSE2, then runs
+	//! along itself left to right and back.  Rows whose neighborhood has settled are skipped.
+	//! The map is cut into bands of rows, and alternate bands are swept in parallel while
+	//! their neighbors wait.
+	//!
+	//! Open or gently varying maps settle in a handful of passes.  Paths that wind back and
+	//! forth, as through a maze, need a pass per turn, and there <code>FlowField</code> is
+	//! faster.
+	class EikonalField
+	{
+		std::vector<float> costs;
+		std::vector<float> directionsX;
+		std::vector<float> directionsY;
+		int goal;
+		unsigned int checksum;
+		float tolerance;
+		int maxPassCount;
+		int passCount;
+		bool converged;
+
+		void ComputeDirections(HexGraph const& graph, unsigned int threadCount);
+
+	public:
+		//! Cost of tiles that cannot reach the goal.
+		static const float UNREACHED;
+
+		//! \brief Default constructor.
+		DLLEXPORT EikonalField();
+
+		//! \brief Sets the change in cost below which the sweeps stop.
+		//!
+		//! Defaults to 0.01.
+		DLLEXPORT void setTolerance(float _tolerance);
+
+		inline float getTolerance() const
+		{
+			return tolerance;
+		}
+
+		//! \brief Sets the most passes over the map that <code>build()</code> makes, or 0 for
+		//! no limit.
+		//!
+		//! A pass is one sweep down and one up.  Defaults to 0.
+		DLLEXPORT void setMaxPassCount(int _maxPassCount);
+
+		inline int getMaxPassCount() const
+		{
+			return maxPassCount;
+		}
+
+		//! \brief Computes the field.
+		//!
+		//! \param   graph        the graph to solve over; the weights are the costs per tile.
+		//! \param   _goal        index of the goal tile.
+		//! \param   threadCount  the number of threads, or 0 to use every hardware thread.
+		//! \return  true if the sweeps converged, false if they stopped at the pass limit.
+		DLLEXPORT bool build(HexGraph const& graph, int _goal, unsigned int threadCount = 0);
+
+		//! \brief Releases the field.
+		DLLEXPORT void clear();
+
+		//! \brief Returns the number of passes the last <code>build()</code> made.
+		inline int getPassCount() const
+		{
+			return passCount;
+		}
+
+		//! \brief Returns true if the last <code>build()</code> ended with a pass that lowered
+		//! no cost by more than the tolerance.
+		inline bool isConverged() const
+		{
+			return converged;
+		}
+
+		//! \brief Returns true if and only if the field was built for the specified graph.
+		inline bool isValidFor(HexGraph const& graph) const
+		{
+			return goal >= 0 && checksum == graph.getChecksum()
+				&& costs.size() == static_cast<size_t>(graph.getTileCount());
+		}
+
+		//! \brief Returns the index of the goal tile, or -1 if the field is empty.
+		inline int getGoal() const
+		{
+			return goal;
+		}
+
+		//! \brief Returns true if the tile can reach the goal.
+		inline bool isReached(int index) const
+		{
+			return costs[index] < UNREACHED;
+		}
+
+		//! \brief Returns the cost from the tile to the goal, or <code>UNREACHED</code>.
+		inline float getCost(int index) const
+		{
+			return costs[index];
+		}
+
+		//! \brief Returns the whole field in row-major order.
+		inline float const* getCosts() const
+		{
+			return costs.empty() ? 0 : &costs[0];
+		}
+
+		//! \brief Returns the east component of the unit direction toward the goal, or zero at
+		//! the goal and on unreached tiles.
+		inline float getDirectionX(int index) const
+		{
+			return directionsX[index];
+		}
+
+		//! \brief Returns the southward component of the unit direction toward the goal, or
+		//! zero at the goal and on unreached tiles.  Rows grow downward.
+		inline float getDirectionY(int index) const
+		{
+			return directionsY[index];
+		}
+
+		//! \brief Returns the adjacent tile with the lowest cost, or -1 at the goal and on
+		//! unreached tiles.
+		//!
+		//! Every reached tile other than the goal has a cheaper neighbor, so stepping from
+		//! tile to tile always ends at the goal.
+		DLLEXPORT int getNextTile(HexGraph const& graph, int index) const;
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_EIKONAL_FIELD_H_
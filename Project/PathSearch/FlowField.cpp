@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <atomic>
+#include "FlowField.h"
+#include "DeltaStepping.h"
+#include "Parallel.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		// Every step costs at most 255, so 256 buckets never wrap onto a pending cost
+		int const BUCKET_COUNT = 256;
+
+		// Stand-in for an unreached cost during sweeps; adding a weight cannot overflow it
+		unsigned int const SWEEP_UNREACHED = 0x7FFFFFFFu;
+
+		inline unsigned int Cheaper(unsigned int a, unsigned int b)
+		{
+			return a < b ? a : b;
+		}
+
+		// Relaxes every tile in one row through the adjacent row above or below it.  Returns
+		// true if any cost dropped.
+		bool RelaxRowFrom(unsigned int* row, unsigned int const* adjacent,
+			unsigned char const* rowWeights, unsigned char const* adjacentWeights,
+			int columnCount, int shift)
+		{
+			bool changed = false;
+
+			// Edge columns have one adjacent tile off the map
+			int const first = shift ? 0 : 1;
+			int const last = shift ? columnCount - 1 : columnCount;
+
+			for (int c = 0; c < first; ++c)
+			{
+				unsigned int best = Cheaper(row[c], adjacent[c] + adjacentWeights[c]);
+				changed |= rowWeights[c] && best < row[c];
+				row[c] = rowWeights[c] ? best : SWEEP_UNREACHED;
+			}
+
+			// Branch-free so the compiler can vectorize it
+			for (int c = first; c < last; ++c)
+			{
+				int left = c + shift - 1;
+				unsigned int best = Cheaper(row[c],
+					Cheaper(adjacent[left] + adjacentWeights[left],
+						adjacent[left + 1] + adjacentWeights[left + 1]));
+				changed |= rowWeights[c] && best < row[c];
+				row[c] = rowWeights[c] ? best : SWEEP_UNREACHED;
+			}
+
+			for (int c = last; c < columnCount; ++c)
+			{
+				int left = c + shift - 1;
+				unsigned int best = Cheaper(row[c], adjacent[left] + adjacentWeights[left]);
+				changed |= rowWeights[c] && best < row[c];
+				row[c] = rowWeights[c] ? best : SWEEP_UNREACHED;
+			}
+
+			return changed;
+		}
+
+		// Relaxes every tile in one row through its left and right neighbors.
+		bool RelaxRowAlong(unsigned int* row, unsigned char const* rowWeights, int columnCount)
+		{
+			bool changed = false;
+
+			for (int c = 1; c < columnCount; ++c)
+			{
+				unsigned int step = row[c - 1] + rowWeights[c - 1];
+				if (rowWeights[c] && step < row[c])
+				{
+					row[c] = step;
+					changed = true;
+				}
+			}
+
+			for (int c = columnCount - 1; c-- > 0; )
+			{
+				unsigned int step = row[c + 1] + rowWeights[c + 1];
+				if (rowWeights[c] && step < row[c])
+				{
+					row[c] = step;
+					changed = true;
+				}
+			}
+
+			return changed;
+		}
+	}
+
+	const unsigned char FlowField::NO_DIRECTION;
+
+	FlowField::FlowField()
+		: goal(-1), checksum(0)
+	{
+	}
+
+	void FlowField::clear()
+	{
+		costs.clear();
+		directions.clear();
+		goal = -1;
+		checksum = 0;
+	}
+
+	void FlowField::build(HexGraph const& graph, int _goal, unsigned int maxCost)
+	{
+		int const tiles = graph.getTileCount();
+		costs.assign(tiles, HexGraph::INFINITE_COST);
+		directions.assign(tiles, NO_DIRECTION);
+		goal = _goal;
+		checksum = graph.getChecksum();
+
+		if (!graph.isPassable(goal))
+			return;
+
+		std::vector<std::vector<int> > buckets(BUCKET_COUNT);
+		int pending = 1;
+		costs[goal] = 0;
+		buckets[0].push_back(goal);
+
+		for (unsigned int current = 0; pending > 0; ++current)
+		{
+			std::vector<int>& bucket = buckets[current % BUCKET_COUNT];
+
+			while (!bucket.empty())
+			{
+				int tile = bucket.back();
+				bucket.pop_back();
+				--pending;
+
+				if (costs[tile] != current)
+					continue;
+
+				// Neighbors reach the goal by stepping onto this tile first
+				unsigned int cost = current + graph.getWeight(tile);
+				if (cost > maxCost)
+					continue;
+
+				for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+				{
+					int neighbor = graph.getNeighbor(tile, d);
+					if (neighbor >= 0 && cost < costs[neighbor])
+					{
+						costs[neighbor] = cost;
+						directions[neighbor] =
+							static_cast<unsigned char>(HexGraph::DIRECTION_COUNT - 1 - d);
+						buckets[cost % BUCKET_COUNT].push_back(neighbor);
+						++pending;
+					}
+				}
+			}
+		}
+	}
+
+	void FlowField::buildParallel(HexGraph const& graph, int _goal, unsigned int maxCost,
+		unsigned int threadCount)
+	{
+		int const rows = graph.getRowCount();
+		int const columns = graph.getColumnCount();
+		int const tiles = graph.getTileCount();
+		unsigned char const* weights = graph.getWeights();
+
+		if (threadCount == 0)
+			threadCount = getDefaultThreadCount();
+
+		costs.assign(tiles, SWEEP_UNREACHED);
+		directions.assign(tiles, NO_DIRECTION);
+		goal = _goal;
+		checksum = graph.getChecksum();
+
+		if (!graph.isPassable(goal))
+		{
+			costs.assign(tiles, HexGraph::INFINITE_COST);
+			return;
+		}
+		costs[goal] = 0;
+
+		// Every tile on a path within maxCost is within this many moves of the goal, and a
+		// move changes the row and the column by at most one, so only this window is swept
+		int rowBegin = 0, rowEnd = rows, columnBegin = 0, columnEnd = columns;
+		if (maxCost < HexGraph::INFINITE_COST)
+		{
+			unsigned int radius = maxCost / graph.getMinimumWeight();
+			int const reach = radius < static_cast<unsigned int>(rows + columns)
+				? static_cast<int>(radius) : rows + columns;
+			int const goalRow = graph.getRow(goal);
+			int const goalColumn = graph.getColumn(goal);
+
+			rowBegin = goalRow > reach ? goalRow - reach : 0;
+			rowEnd = goalRow + reach + 1 < rows ? goalRow + reach + 1 : rows;
+			columnBegin = goalColumn > reach ? goalColumn - reach : 0;
+			columnEnd = goalColumn + reach + 1 < columns ? goalColumn + reach + 1 : columns;
+		}
+		int const windowRows = rowEnd - rowBegin;
+		int const windowColumns = columnEnd - columnBegin;
+
+		// Two bands per thread, so each half of the bands keeps every thread busy
+		int bandCount = static_cast<int>(threadCount) * 2;
+		if (bandCount > windowRows)
+			bandCount = windowRows;
+		int const bandRows = (windowRows + bandCount - 1) / bandCount;
+
+		// Rows start at the window's first column; its edges act as the edges of the map
+		unsigned int* field = &costs[columnBegin];
+		weights += columnBegin;
+		std::atomic<bool> changed(true);
+
+		auto sweepBand = [&](int band)
+		{
+			int begin = rowBegin + band * bandRows;
+			int end = begin + bandRows < rowEnd ? begin + bandRows : rowEnd;
+			bool bandChanged = false;
+
+			// Downward pass, then upward pass
+			for (int r = begin; r < end; ++r)
+			{
+				if (r > rowBegin)
+					bandChanged |= RelaxRowFrom(field + r * columns, field + (r - 1) * columns,
+						weights + r * columns, weights + (r - 1) * columns, windowColumns, r & 1);
+				bandChanged |= RelaxRowAlong(field + r * columns, weights + r * columns,
+					windowColumns);
+			}
+			for (int r = end; r-- > begin; )
+			{
+				if (r + 1 < rowEnd)
+					bandChanged |= RelaxRowFrom(field + r * columns, field + (r + 1) * columns,
+						weights + r * columns, weights + (r + 1) * columns, windowColumns, r & 1);
+				bandChanged |= RelaxRowAlong(field + r * columns, weights + r * columns,
+					windowColumns);
+			}
+
+			if (bandChanged)
+				changed = true;
+		};
+
+		while (changed)
+		{
+			changed = false;
+
+			// Even bands, then odd bands: a band only reads the edge rows of idle neighbors
+			for (int parity = 0; parity < 2; ++parity)
+			{
+				parallelFor((bandCount + 1 - parity) / 2, [&](int b, unsigned int)
+				{
+					sweepBand(b * 2 + parity);
+				}, threadCount);
+			}
+		}
+
+		for (int i = 0; i < tiles; ++i)
+		{
+			if (costs[i] >= SWEEP_UNREACHED || costs[i] > maxCost)
+				costs[i] = HexGraph::INFINITE_COST;
+		}
+
+		ComputeDirections(graph, threadCount);
+	}
+
+	void FlowField::buildDeltaStepping(HexGraph const& graph, int _goal, unsigned int maxCost,
+		unsigned int threadCount, unsigned int delta)
+	{
+		if (threadCount == 0)
+			threadCount = getDefaultThreadCount();
+
+		goal = _goal;
+		checksum = graph.getChecksum();
+		directions.assign(graph.getTileCount(), NO_DIRECTION);
+
+		DeltaStepping search;
+		search.setDelta(delta);
+		search.computeCosts(graph, goal, costs, true, maxCost, threadCount);
+
+		ComputeDirections(graph, threadCount);
+	}
+
+	void FlowField::ComputeDirections(HexGraph const& graph, unsigned int threadCount)
+	{
+		int const columns = graph.getColumnCount();
+
+		parallelFor(graph.getRowCount(), [&](int row, unsigned int)
+		{
+			for (int tile = row * columns; tile < (row + 1) * columns; ++tile)
+			{
+				if (tile == goal || costs[tile] == HexGraph::INFINITE_COST)
+					continue;
+
+				for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+				{
+					int neighbor = graph.getNeighbor(tile, d);
+					if (neighbor >= 0 && costs[neighbor] != HexGraph::INFINITE_COST
+						&& costs[neighbor] + graph.getWeight(neighbor) == costs[tile])
+					{
+						directions[tile] = static_cast<unsigned char>(d);
+						break;
+					}
+				}
+			}
+		}, threadCount);
+	}
+
+	unsigned int FlowField::followPath(HexGraph const& graph, int start,
+		std::vector<Tile const*>& path) const
+	{
+		path.clear();
+		if (goal < 0 || !isReached(start))
+			return HexGraph::INFINITE_COST;
+
+		for (int tile = start; tile >= 0; tile = getNextTile(graph, tile))
+			path.push_back(graph.getTile(tile));
+
+		std::reverse(path.begin(), path.end());
+		return costs[start];
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,133 @@
+//! \file FlowField.h
+//! \brief Defines the fullsail_ai::algorithms::FlowField class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_FLOW_FIELD_H_
+#define _FULLSAIL_AI_PATH_PLANNER_FLOW_FIELD_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Cost to a shared goal and the next step toward it, for every tile at once.
+	//!
+	//! One search from the goal replaces a <code>PathSearch</code> per agent: any agent then
+	//! follows the stored directions to the goal without searching.  The field can be limited
+	//! to a cost radius around the goal; tiles beyond it are left unreached.
+	class FlowField
+	{
+		std::vector<unsigned int> costs;
+		std::vector<unsigned char> directions;
+		int goal;
+		unsigned int checksum;
+
+		void ComputeDirections(HexGraph const& graph, unsigned int threadCount);
+
+	public:
+		//! Direction stored for the goal and for tiles that cannot reach it.
+		static const unsigned char NO_DIRECTION = 0xFF;
+
+		//! \brief Default constructor.
+		DLLEXPORT FlowField();
+
+		//! \brief Computes the field with a reverse Dijkstra search from the goal.
+		//!
+		//! Uses a bucket queue over the byte weights, so the search runs in time linear in the
+		//! number of tiles reached.
+		//!
+		//! \param   graph    the graph to search.
+		//! \param   _goal    index of the goal tile.
+		//! \param   maxCost  tiles whose cost to the goal exceeds this are left unreached.
+		DLLEXPORT void build(HexGraph const& graph, int _goal,
+			unsigned int maxCost = HexGraph::INFINITE_COST);
+
+		//! \brief Computes the same field as <code>build()</code> by repeated row sweeps.
+		//!
+		//! The map is cut into bands of rows.  Alternate bands sweep their rows down and up in
+		//! parallel while their neighbors wait, until a full pass changes nothing.  Each row
+		//! relaxes from the adjacent row in one branch-free loop the compiler can vectorize.
+		//! This beats the sequential search on large open maps, but needs many passes on
+		//! maze-like maps where paths wind back and forth across the bands.
+		//!
+		//! \param   graph        the graph to search.
+		//! \param   _goal        index of the goal tile.
+		//! \param   maxCost      tiles whose cost to the goal exceeds this are left unreached.
+		//!                       Only the rows and columns within <code>maxCost</code> over
+		//!                       the lowest weight moves of the goal are swept.
+		//! \param   threadCount  the number of threads, or 0 to use every hardware thread.
+		DLLEXPORT void buildParallel(HexGraph const& graph, int _goal,
+			unsigned int maxCost = HexGraph::INFINITE_COST, unsigned int threadCount = 0);
+
+		//! \brief Computes the same field as <code>build()</code> with a parallel
+		//! delta-stepping search.
+		//!
+		//! Unlike the sweeps, the work does not grow with how much the paths wind, so this
+		//! suits large maps of any shape.  See <code>DeltaStepping</code>.
+		//!
+		//! \param   graph        the graph to search.
+		//! \param   _goal        index of the goal tile.
+		//! \param   maxCost      tiles whose cost to the goal exceeds this are left unreached.
+		//! \param   threadCount  the number of threads, or 0 to use every hardware thread.
+		//! \param   delta        the bucket width, or 0 to pick one from the weights.
+		DLLEXPORT void buildDeltaStepping(HexGraph const& graph, int _goal,
+			unsigned int maxCost = HexGraph::INFINITE_COST, unsigned int threadCount = 0,
+			unsigned int delta = 0);
+
+		//! \brief Releases the field.
+		DLLEXPORT void clear();
+
+		//! \brief Returns true if and only if the field was built for the specified graph.
+		inline bool isValidFor(HexGraph const& graph) const
+		{
+			return goal >= 0 && checksum == graph.getChecksum()
+				&& costs.size() == static_cast<size_t>(graph.getTileCount());
+		}
+
+		//! \brief Returns the index of the goal tile, or -1 if the field is empty.
+		inline int getGoal() const
+		{
+			return goal;
+		}
+
+		//! \brief Returns true if the tile can reach the goal within the field's radius.
+		inline bool isReached(int index) const
+		{
+			return costs[index] != HexGraph::INFINITE_COST;
+		}
+
+		//! \brief Returns the cost from the tile to the goal, or
+		//! <code>HexGraph::INFINITE_COST</code> if it is not reached.
+		inline unsigned int getCost(int index) const
+		{
+			return costs[index];
+		}
+
+		//! \brief Returns the direction of the next step toward the goal, or
+		//! <code>NO_DIRECTION</code> at the goal and on unreached tiles.
+		inline unsigned char getDirection(int index) const
+		{
+			return directions[index];
+		}
+
+		//! \brief Returns the next tile toward the goal, or -1 at the goal and on unreached
+		//! tiles.
+		inline int getNextTile(HexGraph const& graph, int index) const
+		{
+			return directions[index] == NO_DIRECTION ? -1
+				: graph.getNeighbor(index, directions[index]);
+		}
+
+		//! \brief Follows the field from a tile to the goal.
+		//!
+		//! \param   graph  the graph the field was built for.
+		//! \param   start  index of the tile to start from.
+		//! \param   path   receives the tiles ordered like
+		//!                 <code>PathSearch::getSolution()</code>: goal first, start last.
+		//!                 Left empty if the start is not reached.
+		//! \return  the cost of the path, or <code>HexGraph::INFINITE_COST</code>.
+		DLLEXPORT unsigned int followPath(HexGraph const& graph, int start,
+			std::vector<Tile const*>& path) const;
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_FLOW_FIELD_H_
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include "HashDistributedSearch.h"
+#include "Parallel.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		// Successors sent in one batch, and expansions between flushes of partial batches
+		int const BATCH_SIZE = 64;
+		int const FLUSH_INTERVAL = 16;
+
+		struct Message
+		{
+			int tile;
+			int parent;
+			unsigned int givenCost;
+		};
+
+		struct Batch
+		{
+			std::vector<Message> messages;
+			Batch* next;
+		};
+
+		// Lock-free multi-producer, single-consumer queue: producers push batches onto a
+		// list, and the owner takes the whole list at once.  Padded so that the queues of
+		// different workers do not share a cache line.
+		struct alignas(64) Inbox
+		{
+			std::atomic<Batch*> head;
+
+			Inbox()
+				: head(nullptr)
+			{
+			}
+
+			void push(Batch* batch)
+			{
+				batch->next = head.load(std::memory_order_relaxed);
+				while (!head.compare_exchange_weak(batch->next, batch,
+					std::memory_order_release, std::memory_order_relaxed))
+				{
+				}
+			}
+
+			Batch* takeAll()
+			{
+				return head.exchange(nullptr, std::memory_order_acquire);
+			}
+		};
+
+		struct Entry
+		{
+			unsigned int estimate;
+			unsigned int givenCost;
+			int tile;
+		};
+
+		// Lowest estimate on top, ties to the deepest node
+		struct CompareEntries
+		{
+			bool operator()(Entry const& a, Entry const& b) const
+			{
+				return a.estimate > b.estimate
+					|| (a.estimate == b.estimate && a.givenCost < b.givenCost);
+			}
+		};
+	}
+
+	HashDistributedSearch::HashDistributedSearch()
+		: blockSize(8), workerCount(0), cost(HexGraph::INFINITE_COST),
+		lowerBound(HexGraph::INFINITE_COST)
+	{
+	}
+
+	void HashDistributedSearch::setBlockSize(int _blockSize)
+	{
+		blockSize = _blockSize > 0 ? _blockSize : 1;
+	}
+
+	unsigned int HashDistributedSearch::findPath(HexGraph const& graph, int start, int goal,
+		std::vector<Tile const*>& path, unsigned int threadCount,
+		LandmarkTable const* landmarks)
+	{
+		path.clear();
+		cost = lowerBound = HexGraph::INFINITE_COST;
+		workerCount = threadCount != 0 ? threadCount : getDefaultThreadCount();
+		records.assign(workerCount, std::unordered_map<int, Record>());
+		WorkerStats noWork = { 0, 0, 0 };
+		stats.assign(workerCount, noWork);
+
+		if (!graph.isPassable(start) || !graph.isPassable(goal))
+			return cost;
+
+		if (start == goal)
+		{
+			path.push_back(graph.getTile(start));
+			return cost = 0;
+		}
+
+		// Fixed keys, so a query always splits the same way
+		std::mt19937 random(0x9E3779B9u);
+		rowKeys.resize((graph.getRowCount() + blockSize - 1) / blockSize);
+		columnKeys.resize((graph.getColumnCount() + blockSize - 1) / blockSize);
+		for (int i = 0; i < static_cast<int>(rowKeys.size()); ++i)
+			rowKeys[i] = random();
+		for (int i = 0; i < static_cast<int>(columnKeys.size()); ++i)
+			columnKeys[i] = random();
+
+		bool const useLandmarks = landmarks != 0 && landmarks->isValidFor(graph);
+		unsigned int const minimumWeight = graph.getMinimumWeight();
+		auto estimate = [&](int tile) -> unsigned int
+		{
+			return useLandmarks ? landmarks->estimate(graph, tile, goal)
+				: graph.getHexDistance(tile, goal) * minimumWeight;
+		};
+
+		std::vector<std::vector<Entry> > open(workerCount);
+		std::unique_ptr<Inbox[]> inboxes(new Inbox[workerCount]);
+		std::atomic<unsigned int> incumbent(HexGraph::INFINITE_COST);
+		// Busy workers plus unread messages; the search is over when it reaches zero
+		std::atomic<long long> pending(workerCount);
+
+		unsigned int startOwner = Owner(graph, start);
+		Record startRecord = { 0, -1 };
+		records[startOwner][start] = startRecord;
+		Entry startEntry = { estimate(start), 0, start };
+		open[startOwner].push_back(startEntry);
+
+		auto run = [&](unsigned int self)
+		{
+			std::vector<Entry>& heap = open[self];
+			std::unordered_map<int, Record>& owned = records[self];
+			WorkerStats& work = stats[self];
+			std::vector<std::vector<Message> > outboxes(workerCount);
+			int sinceFlush = 0;
+
+			auto flush = [&](unsigned int to)
+			{
+				if (outboxes[to].empty())
+					return;
+
+				Batch* batch = new Batch();
+				batch->messages.swap(outboxes[to]);
+				outboxes[to].reserve(BATCH_SIZE);
+				work.sentCount += static_cast<unsigned int>(batch->messages.size());
+				pending += static_cast<long long>(batch->messages.size());
+				inboxes[to].push(batch);
+			};
+
+			auto relax = [&](int tile, int parent, unsigned int givenCost)
+			{
+				if (givenCost + estimate(tile) >= incumbent.load(std::memory_order_relaxed))
+					return;
+
+				auto found = owned.find(tile);
+				if (found != owned.end() && found->second.givenCost <= givenCost)
+					return;
+
+				Record record = { givenCost, parent };
+				owned[tile] = record;
+
+				if (tile == goal)
+				{
+					unsigned int best = incumbent.load();
+					while (givenCost < best && !incumbent.compare_exchange_weak(best, givenCost))
+					{
+					}
+					return;
+				}
+
+				Entry entry = { givenCost + estimate(tile), givenCost, tile };
+				heap.push_back(entry);
+				std::push_heap(heap.begin(), heap.end(), CompareEntries());
+			};
+
+			for (;;)
+			{
+				for (Batch* batch = inboxes[self].takeAll(); batch != 0; )
+				{
+					std::vector<Message> const& messages = batch->messages;
+					for (int i = 0; i < static_cast<int>(messages.size()); ++i)
+						relax(messages[i].tile, messages[i].parent, messages[i].givenCost);
+
+					work.receivedCount += static_cast<unsigned int>(messages.size());
+					pending -= static_cast<long long>(messages.size());
+
+					Batch* next = batch->next;
+					delete batch;
+					batch = next;
+				}
+
+				// Take the best node that can still beat the incumbent
+				bool expanded = false;
+				while (!heap.empty() && heap.front().estimate < incumbent.load())
+				{
+					std::pop_heap(heap.begin(), heap.end(), CompareEntries());
+					Entry current = heap.back();
+					heap.pop_back();
+
+					// Skip stale entries left behind by cheaper arrivals
+					if (owned[current.tile].givenCost != current.givenCost)
+						continue;
+
+					++work.expandedCount;
+					for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+					{
+						int successor = graph.getNeighbor(current.tile, d);
+						if (successor < 0)
+							continue;
+
+						unsigned int givenCost = current.givenCost + graph.getWeight(successor);
+						unsigned int owner = Owner(graph, successor);
+						if (owner == self)
+						{
+							relax(successor, current.tile, givenCost);
+						}
+						else if (givenCost + estimate(successor) < incumbent.load())
+						{
+							Message message = { successor, current.tile, givenCost };
+							outboxes[owner].push_back(message);
+							if (static_cast<int>(outboxes[owner].size()) >= BATCH_SIZE)
+								flush(owner);
+						}
+					}
+
+					expanded = true;
+					break;
+				}
+
+				if (expanded && ++sinceFlush < FLUSH_INTERVAL)
+					continue;
+
+				for (unsigned int to = 0; to < workerCount; ++to)
+					flush(to);
+				sinceFlush = 0;
+
+				if (expanded)
+					continue;
+
+				// Nothing left below the incumbent: idle until a message comes or every
+				// worker is idle with nothing in flight
+				--pending;
+				for (;;)
+				{
+					if (pending.load() == 0)
+						return;
+
+					if (inboxes[self].head.load(std::memory_order_relaxed) != 0)
+					{
+						++pending;
+						break;
+					}
+
+					std::this_thread::yield();
+				}
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (unsigned int t = 1; t < workerCount; ++t)
+			threads.push_back(std::thread(run, t));
+		run(0);
+		for (int t = 0; t < static_cast<int>(threads.size()); ++t)
+			threads[t].join();
+
+		// Optimality check: nothing left open may promise a cheaper path
+		for (unsigned int w = 0; w < workerCount; ++w)
+		{
+			for (int i = 0; i < static_cast<int>(open[w].size()); ++i)
+			{
+				Entry const& entry = open[w][i];
+				if (records[w][entry.tile].givenCost == entry.givenCost
+					&& entry.estimate < lowerBound)
+					lowerBound = entry.estimate;
+			}
+		}
+
+		cost = incumbent.load();
+		if (cost == HexGraph::INFINITE_COST)
+			return cost;
+
+		for (int tile = goal; tile >= 0; tile = records[Owner(graph, tile)][tile].parent)
+			path.push_back(graph.getTile(tile));
+
+		return cost;
+	}
+
+	unsigned int HashDistributedSearch::getExpandedCount() const
+	{
+		unsigned int total = 0;
+		for (int w = 0; w < static_cast<int>(stats.size()); ++w)
+			total += stats[w].expandedCount;
+		return total;
+	}
+}}  // namespace fullsail_ai::algorithms
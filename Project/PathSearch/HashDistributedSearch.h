@@ -0,0 +1,122 @@
+//! \file HashDistributedSearch.h
+//! \brief Defines the fullsail_ai::algorithms::HashDistributedSearch class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_HASH_DISTRIBUTED_SEARCH_H_
+#define _FULLSAIL_AI_PATH_PLANNER_HASH_DISTRIBUTED_SEARCH_H_
+
+#include <vector>
+#include <unordered_map>
+#include "HexGraph.h"
+#include "Landmarks.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Hash-distributed A* (HDA*): one query searched by several threads at once.
+	//!
+	//! Every tile belongs to one worker, chosen by Zobrist hashing of the block of tiles it
+	//! lies in, so neighbors usually share a worker and most successors stay local.  Each
+	//! worker keeps the open and closed lists of its own tiles; a successor owned by another
+	//! worker is sent to it in batches through a lock-free queue that many workers push to
+	//! and only the owner drains.
+	//!
+	//! The best path to the goal found so far, the incumbent, prunes every node that cannot
+	//! beat it.  The search ends when no worker has a node left below the incumbent and no
+	//! message is in flight; a single counter of busy workers plus unread messages detects
+	//! that without a race, since only a busy worker can send and a worker counts itself busy
+	//! before it reads.  The incumbent is then optimal, and <code>getLowerBound()</code>
+	//! reports the check.
+	//!
+	//! The heuristic is the hex distance times the lowest weight, or a landmark table.
+	class HashDistributedSearch
+	{
+	public:
+		//! \brief Work done by one worker in the last search.
+		struct WorkerStats
+		{
+			unsigned int expandedCount;
+			unsigned int sentCount;
+			unsigned int receivedCount;
+		};
+
+	private:
+		struct Record
+		{
+			unsigned int givenCost;
+			int parent;
+		};
+
+		int blockSize;
+		std::vector<unsigned int> rowKeys;
+		std::vector<unsigned int> columnKeys;
+		unsigned int workerCount;
+		// Per worker, the tiles it owns that the last search reached
+		std::vector<std::unordered_map<int, Record> > records;
+		std::vector<WorkerStats> stats;
+		unsigned int cost;
+		unsigned int lowerBound;
+
+		inline unsigned int Owner(HexGraph const& graph, int tile) const
+		{
+			int row = graph.getRow(tile) / blockSize;
+			int column = graph.getColumn(tile) / blockSize;
+			return (rowKeys[row] ^ columnKeys[column]) % workerCount;
+		}
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT HashDistributedSearch();
+
+		//! \brief Sets the side of the square blocks of tiles that share an owner.
+		//!
+		//! Larger blocks send fewer messages; smaller ones spread a narrow search over more
+		//! workers.  The default is 8.
+		DLLEXPORT void setBlockSize(int _blockSize);
+
+		//! \brief Finds a cheapest path with several threads.
+		//!
+		//! \param   graph        the graph to search.
+		//! \param   start        index of the tile to start from.
+		//! \param   goal         index of the tile to reach.
+		//! \param   path         receives the tiles ordered like
+		//!                       <code>PathSearch::getSolution()</code>: goal first, start
+		//!                       last.  Left empty if there is no path.
+		//! \param   threadCount  the number of workers, or 0 to use every hardware thread.
+		//! \param   landmarks    optional landmark tables built for the graph, for a sharper
+		//!                       heuristic.
+		//! \return  the cost of the path, or <code>HexGraph::INFINITE_COST</code>.
+		DLLEXPORT unsigned int findPath(HexGraph const& graph, int start, int goal,
+			std::vector<Tile const*>& path, unsigned int threadCount = 0,
+			LandmarkTable const* landmarks = 0);
+
+		//! \brief Returns the cost of the last path, or <code>HexGraph::INFINITE_COST</code>.
+		inline unsigned int getCost() const
+		{
+			return cost;
+		}
+
+		//! \brief Returns the lowest cost estimate left open when the last search ended, or
+		//! <code>HexGraph::INFINITE_COST</code> if nothing was left.
+		//!
+		//! It is at least <code>getCost()</code> whenever the path is optimal.
+		inline unsigned int getLowerBound() const
+		{
+			return lowerBound;
+		}
+
+		//! \brief Returns the number of workers of the last search.
+		inline unsigned int getWorkerCount() const
+		{
+			return workerCount;
+		}
+
+		inline WorkerStats const& getWorkerStats(unsigned int worker) const
+		{
+			return stats[worker];
+		}
+
+		//! \brief Returns the number of nodes expanded by all workers in the last search.
+		DLLEXPORT unsigned int getExpandedCount() const;
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_HASH_DISTRIBUTED_SEARCH_H_
@@ -0,0 +1,25 @@
+#include "HeuristicTable.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		int const INITIAL_BITS = 6;
+	}
+
+	HeuristicTable::HeuristicTable()
+		: table(INITIAL_BITS)
+	{
+	}
+
+	void HeuristicTable::clear()
+	{
+		table.reset();
+	}
+
+	void HeuristicTable::set(int tile, unsigned int value)
+	{
+		bool added;
+		table.insert(tile, added) = value;
+	}
+}}  // namespace fullsail_ai::algorithms
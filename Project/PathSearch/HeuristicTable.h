@@ -0,0 +1,53 @@
+//! \file HeuristicTable.h
+//! \brief Defines the fullsail_ai::algorithms::HeuristicTable class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_HEURISTIC_TABLE_H_
+#define _FULLSAIL_AI_PATH_PLANNER_HEURISTIC_TABLE_H_
+
+#include <cstddef>
+#include "StampedHashTable.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Heuristic values learned for some tiles of a map, toward one goal.
+	//!
+	//! A <code>StampedHashTable</code> of (tile, value) pairs, twelve bytes each, so that
+	//! only the few tiles a search has learned about cost memory.  Tiles not in the table
+	//! keep whatever initial heuristic the caller supplies.
+	class HeuristicTable
+	{
+		StampedHashTable<int, unsigned int> table;
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT HeuristicTable();
+
+		//! \brief Forgets every value and releases all but the initial capacity.
+		DLLEXPORT void clear();
+
+		//! \brief Stores the value of a tile, replacing any previous one.
+		DLLEXPORT void set(int tile, unsigned int value);
+
+		//! \brief Returns the value stored for a tile, or <code>initial</code> if there is
+		//! none.
+		inline unsigned int get(int tile, unsigned int initial) const
+		{
+			unsigned int const* value = table.find(tile);
+			return value != 0 ? *value : initial;
+		}
+
+		//! \brief Returns the number of tiles with a stored value.
+		inline size_t getCount() const
+		{
+			return table.getCount();
+		}
+
+		//! \brief Returns the bytes held by the table.
+		inline size_t getMemoryUsage() const
+		{
+			return table.getMemoryUsage();
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_HEURISTIC_TABLE_H_
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include "HexBitboard.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		inline int CountBits(unsigned long long word)
+		{
+			word = word - ((word >> 1) & 0x5555555555555555ULL);
+			word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+			word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+			return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+		}
+	}
+
+	HexBitboard::HexBitboard()
+		: rowCount(0), columnCount(0), wordCount(0), stride(0)
+	{
+	}
+
+	void HexBitboard::resize(int _rowCount, int _columnCount)
+	{
+		rowCount = _rowCount;
+		columnCount = _columnCount;
+		wordCount = (columnCount + 63) >> 6;
+
+		// A zero word on each side, and room for a four-word access starting at the last
+		// word of the row
+		stride = (wordCount + 4 + 3) & ~3;
+		words.assign((rowCount + 2) * stride + 4, 0);
+	}
+
+	void HexBitboard::build(HexGraph const& graph)
+	{
+		resize(graph.getRowCount(), graph.getColumnCount());
+
+		unsigned char const* weights = graph.getWeights();
+		for (int row = 0; row < rowCount; ++row)
+		{
+			unsigned long long* bits = getRow(row);
+			unsigned char const* rowWeights = weights + row * columnCount;
+			for (int column = 0; column < columnCount; ++column)
+			{
+				if (rowWeights[column] != 0)
+					bits[column >> 6] |= 1ULL << (column & 63);
+			}
+		}
+	}
+
+	void HexBitboard::clear()
+	{
+		std::fill(words.begin(), words.end(), 0ULL);
+	}
+
+	void HexBitboard::clearRows(int first, int last)
+	{
+		if (first > last)
+			return;
+
+		std::fill(words.begin() + (first + 1) * stride, words.begin() + (last + 2) * stride, 0ULL);
+	}
+
+	int HexBitboard::count() const
+	{
+		return countRows(0, rowCount - 1);
+	}
+
+	int HexBitboard::countRows(int first, int last) const
+	{
+		int total = 0;
+		for (int i = (first + 1) * stride; i < (last + 2) * stride; ++i)
+			total += CountBits(words[i]);
+		return total;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,109 @@
+//! \file HexBitboard.h
+//! \brief Defines the fullsail_ai::algorithms::HexBitboard class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_HEX_BITBOARD_H_
+#define _FULLSAIL_AI_PATH_PLANNER_HEX_BITBOARD_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief One bit per tile of a hex map, such as the passable mask, stored row by row in
+	//! 64-bit words so that whole rows can be shifted and masked at once.
+	//!
+	//! Bit <code>c % 64</code> of word <code>c / 64</code> of a row holds column
+	//! <code>c</code>.  Every row is framed by zero words, and the map by a zero row above
+	//! and below, so a kernel may read one word and one row past any edge without checks.
+	//! Rows are padded to a multiple of four words plus room for a 256-bit load or store to
+	//! start at any word of the row.  Bits past the last column stay zero.
+	class HexBitboard
+	{
+		int rowCount;
+		int columnCount;
+		int wordCount;
+		int stride;
+		std::vector<unsigned long long> words;
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT HexBitboard();
+
+		//! \brief Sets the size of the board and clears every bit.
+		DLLEXPORT void resize(int _rowCount, int _columnCount);
+
+		//! \brief Sets the size of the board to that of the graph and sets the bits of its
+		//! passable tiles.
+		DLLEXPORT void build(HexGraph const& graph);
+
+		//! \brief Clears every bit.
+		DLLEXPORT void clear();
+
+		//! \brief Clears every bit of the rows from <code>first</code> to <code>last</code>.
+		DLLEXPORT void clearRows(int first, int last);
+
+		//! \brief Returns the number of bits set.
+		DLLEXPORT int count() const;
+
+		//! \brief Returns the number of bits set in the rows from <code>first</code> to
+		//! <code>last</code>.
+		DLLEXPORT int countRows(int first, int last) const;
+
+		inline int getRowCount() const
+		{
+			return rowCount;
+		}
+
+		inline int getColumnCount() const
+		{
+			return columnCount;
+		}
+
+		//! \brief Returns the number of words holding the columns of one row.
+		inline int getWordCount() const
+		{
+			return wordCount;
+		}
+
+		//! \brief Returns true if both boards have the same size.
+		inline bool isSameSize(HexBitboard const& other) const
+		{
+			return rowCount == other.rowCount && columnCount == other.columnCount;
+		}
+
+		//! \brief Returns the first word of a row.  Rows -1 and <code>getRowCount()</code>
+		//! are the zero rows framing the map.
+		inline unsigned long long* getRow(int row)
+		{
+			return &words[(row + 1) * stride + 1];
+		}
+
+		inline unsigned long long const* getRow(int row) const
+		{
+			return &words[(row + 1) * stride + 1];
+		}
+
+		inline bool test(int row, int column) const
+		{
+			return (getRow(row)[column >> 6] >> (column & 63)) & 1;
+		}
+
+		//! \brief Returns the bit of the tile at a row-major index.
+		inline bool test(int index) const
+		{
+			return test(index / columnCount, index % columnCount);
+		}
+
+		inline void set(int row, int column)
+		{
+			getRow(row)[column >> 6] |= 1ULL << (column & 63);
+		}
+
+		inline void reset(int row, int column)
+		{
+			getRow(row)[column >> 6] &= ~(1ULL << (column & 63));
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_HEX_BITBOARD_H_
@@ -0,0 +1,108 @@
+#include <queue>
+#include <functional>
+#include "HexGraph.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	const int HexGraph::DIRECTION_COUNT;
+	const unsigned int HexGraph::INFINITE_COST;
+
+	HexGraph::HexGraph()
+		: tileMap(0), rowCount(0), columnCount(0), checksum(0), minimumWeight(0)
+	{
+	}
+
+	void HexGraph::build(TileMap const* _tileMap)
+	{
+		build(_tileMap, 0);
+	}
+
+	void HexGraph::build(TileMap const* _tileMap, unsigned char const* costPlane)
+	{
+		clear();
+		tileMap = _tileMap;
+		rowCount = tileMap->getRowCount();
+		columnCount = tileMap->getColumnCount();
+		weights.resize(rowCount * columnCount);
+
+		// FNV-1a over the dimensions and every weight
+		checksum = 2166136261u;
+		checksum = (checksum ^ static_cast<unsigned int>(rowCount)) * 16777619u;
+		checksum = (checksum ^ static_cast<unsigned int>(columnCount)) * 16777619u;
+
+		for (int row = 0; row < rowCount; ++row)
+		{
+			for (int col = 0; col < columnCount; ++col)
+			{
+				unsigned char weight = tileMap->getTile(row, col)->getWeight();
+				if (weight != 0 && costPlane != 0)
+					weight = costPlane[row * columnCount + col];
+				weights[row * columnCount + col] = weight;
+				checksum = (checksum ^ weight) * 16777619u;
+
+				if (weight != 0 && (minimumWeight == 0 || weight < minimumWeight))
+					minimumWeight = weight;
+			}
+		}
+	}
+
+	void HexGraph::clear()
+	{
+		tileMap = 0;
+		rowCount = columnCount = 0;
+		checksum = 0;
+		minimumWeight = 0;
+		weights.clear();
+	}
+
+	int HexGraph::getDirection(int from, int to) const
+	{
+		for (int d = 0; d < DIRECTION_COUNT; ++d)
+		{
+			if (getNeighbor(from, d) == to)
+				return d;
+		}
+
+		return -1;
+	}
+
+	void HexGraph::computeCosts(int source, std::vector<unsigned int>& costs,
+		std::vector<int>* parents, unsigned int maxCost) const
+	{
+		typedef std::pair<unsigned int, int> Entry;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+
+		costs.assign(getTileCount(), INFINITE_COST);
+		if (parents != 0)
+			parents->assign(getTileCount(), -1);
+
+		costs[source] = 0;
+		open.push(Entry(0, source));
+
+		while (!open.empty())
+		{
+			Entry current = open.top();
+			open.pop();
+
+			// Skip stale entries left behind by cheaper pushes
+			if (current.first != costs[current.second])
+				continue;
+
+			for (int d = 0; d < DIRECTION_COUNT; ++d)
+			{
+				int successor = getNeighbor(current.second, d);
+				if (successor < 0)
+					continue;
+
+				unsigned int newCost = current.first + weights[successor];
+				if (newCost < costs[successor] && newCost <= maxCost)
+				{
+					costs[successor] = newCost;
+					if (parents != 0)
+						(*parents)[successor] = current.second;
+					open.push(Entry(newCost, successor));
+				}
+			}
+		}
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,208 @@
+//! \file HexGraph.h
+//! \brief Defines the fullsail_ai::algorithms::HexGraph class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_HEX_GRAPH_H_
+#define _FULLSAIL_AI_PATH_PLANNER_HEX_GRAPH_H_
+
+#include <vector>
+#include "../TileSystem/Tile.h"
+#include "../TileSystem/TileMap.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Flat, read-only snapshot of a tile map used by the precomputed searches.
+	//!
+	//! Tiles are addressed by their row-major index (<code>row * columnCount + column</code>)
+	//! and weights are kept in one contiguous array, so the graph can be shared between
+	//! threads without touching the <code>Tile</code> objects.  Directions follow the order of
+	//! the neighbor offsets used by <code>PathSearch</code>: up-left, up-right, left, right,
+	//! down-left, down-right.  The opposite of direction <code>d</code> is
+	//! <code>DIRECTION_COUNT - 1 - d</code>.
+	//!
+	//! Moving onto a tile costs that tile's weight, so the cost of a path does not include the
+	//! weight of its first tile.
+	class HexGraph
+	{
+		TileMap const* tileMap;
+		int rowCount;
+		int columnCount;
+		std::vector<unsigned char> weights;
+		unsigned int checksum;
+		unsigned char minimumWeight;
+
+	public:
+		static const int DIRECTION_COUNT = 6;
+		static const unsigned int INFINITE_COST = 0xFFFFFFFFu;
+
+		//! \brief Default constructor.
+		DLLEXPORT HexGraph();
+
+		//! \brief Takes a snapshot of the weights in the specified tile map.
+		//!
+		//! Must be invoked again whenever the tile map is reloaded or changed.
+		DLLEXPORT void build(TileMap const* _tileMap);
+
+		//! \brief Takes a snapshot of a unit class's step costs instead of the tile weights.
+		//!
+		//! Every search on the graph then reads the unit class's costs directly.  Walls in the
+		//! tile map stay impassable whatever the plane says.
+		//!
+		//! \param   _tileMap   the tile map the costs were computed for.
+		//! \param   costPlane  one cost per tile in row-major order, zero for impassable, as
+		//!                     filled by <code>computeCostPlane()</code>.
+		DLLEXPORT void build(TileMap const* _tileMap, unsigned char const* costPlane);
+
+		//! \brief Releases the snapshot.
+		DLLEXPORT void clear();
+
+		//! \brief Returns true if and only if the graph holds a snapshot.
+		inline bool isBuilt() const
+		{
+			return tileMap != 0;
+		}
+
+		//! \brief Returns the tile map the snapshot was taken from.
+		inline TileMap const* getTileMap() const
+		{
+			return tileMap;
+		}
+
+		inline int getRowCount() const
+		{
+			return rowCount;
+		}
+
+		inline int getColumnCount() const
+		{
+			return columnCount;
+		}
+
+		inline int getTileCount() const
+		{
+			return rowCount * columnCount;
+		}
+
+		//! \brief Returns a hash of the map size and weights, used to validate saved tables.
+		inline unsigned int getChecksum() const
+		{
+			return checksum;
+		}
+
+		inline int toIndex(int row, int column) const
+		{
+			return row * columnCount + column;
+		}
+
+		inline int toIndex(Tile const* tile) const
+		{
+			return tile->getRow() * columnCount + tile->getColumn();
+		}
+
+		inline int getRow(int index) const
+		{
+			return index / columnCount;
+		}
+
+		inline int getColumn(int index) const
+		{
+			return index % columnCount;
+		}
+
+		//! \brief Returns the weight of the tile at the index, or zero if it is impassable.
+		inline unsigned char getWeight(int index) const
+		{
+			return weights[index];
+		}
+
+		inline bool isPassable(int index) const
+		{
+			return weights[index] != 0;
+		}
+
+		//! \brief Returns the lowest weight of any passable tile, or zero if there is none.
+		inline unsigned char getMinimumWeight() const
+		{
+			return minimumWeight;
+		}
+
+		//! \brief Returns the number of moves between two tiles on an open map.
+		//!
+		//! Multiplied by <code>getMinimumWeight()</code> it never overestimates the cost of
+		//! a path, so it serves as an admissible heuristic that needs no preprocessing.
+		inline int getHexDistance(int from, int to) const
+		{
+			// Cube coordinates of odd-row-shifted offsets
+			int fromRow = from / columnCount;
+			int toRow = to / columnCount;
+			int dz = toRow - fromRow;
+			int dx = (to % columnCount - (toRow >> 1)) - (from % columnCount - (fromRow >> 1));
+			int dy = -dx - dz;
+
+			dx = dx < 0 ? -dx : dx;
+			dy = dy < 0 ? -dy : dy;
+			dz = dz < 0 ? -dz : dz;
+			return dx > dy ? (dx > dz ? dx : dz) : (dy > dz ? dy : dz);
+		}
+
+		//! \brief Returns the contiguous, row-major weight array.
+		inline unsigned char const* getWeights() const
+		{
+			return weights.empty() ? 0 : &weights[0];
+		}
+
+		//! \brief Returns the tile at the index.
+		inline Tile* getTile(int index) const
+		{
+			return tileMap->getTile(index / columnCount, index % columnCount);
+		}
+
+		//! \brief Returns the index of the tile adjacent to <code>index</code> in the specified
+		//! direction, passable or not, or -1 if that tile is off the map.
+		inline int getAdjacent(int index, int direction) const
+		{
+			int row = index / columnCount;
+			int column = index % columnCount;
+			int odd = row & 1;
+
+			switch (direction)
+			{
+			case 0: --row; column += odd - 1; break;
+			case 1: --row; column += odd; break;
+			case 2: --column; break;
+			case 3: ++column; break;
+			case 4: ++row; column += odd - 1; break;
+			default: ++row; column += odd; break;
+			}
+
+			if (row < 0 || column < 0 || row >= rowCount || column >= columnCount)
+				return -1;
+
+			return row * columnCount + column;
+		}
+
+		//! \brief Returns the index of the tile adjacent to <code>index</code> in the specified
+		//! direction, or -1 if that tile is off the map or impassable.
+		inline int getNeighbor(int index, int direction) const
+		{
+			int neighbor = getAdjacent(index, direction);
+			return neighbor >= 0 && weights[neighbor] ? neighbor : -1;
+		}
+
+		//! \brief Returns the direction that leads from <code>from</code> to the adjacent
+		//! tile <code>to</code>, or -1 if the tiles are not adjacent.
+		DLLEXPORT int getDirection(int from, int to) const;
+
+		//! \brief Computes the cost of the cheapest path from the source to every tile.
+		//!
+		//! \param   source    index of the tile to start from.
+		//! \param   costs     receives one cost per tile, <code>INFINITE_COST</code> if the
+		//!                    tile was not reached.
+		//! \param   parents   if not <code>NULL</code>, receives the predecessor of each
+		//!                    reached tile, -1 for the source and unreached tiles.
+		//! \param   maxCost   tiles costing more than this are left unreached.
+		DLLEXPORT void computeCosts(int source, std::vector<unsigned int>& costs,
+			std::vector<int>* parents = 0, unsigned int maxCost = INFINITE_COST) const;
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_HEX_GRAPH_H_
@@ -0,0 +1,270 @@
+#include <fstream>
+#include <cstring>
+#include "Landmarks.h"
+#include "Parallel.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		char const LANDMARK_FILE_TAG[4] = { 'A', 'L', 'T', '1' };
+		int const UNREACHED_HOPS = 0x7FFFFFFF;
+
+		// Breadth-first move counts from the seed over passable tiles
+		void SweepHops(HexGraph const& graph, int seed, std::vector<int>& hops)
+		{
+			std::vector<int> frontier(1, seed);
+			std::vector<int> next;
+
+			hops.assign(graph.getTileCount(), UNREACHED_HOPS);
+			hops[seed] = 0;
+
+			for (int depth = 1; !frontier.empty(); ++depth)
+			{
+				next.clear();
+				for (size_t f = 0; f < frontier.size(); ++f)
+				{
+					for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+					{
+						int neighbor = graph.getNeighbor(frontier[f], d);
+						if (neighbor >= 0 && hops[neighbor] == UNREACHED_HOPS)
+						{
+							hops[neighbor] = depth;
+							next.push_back(neighbor);
+						}
+					}
+				}
+				frontier.swap(next);
+			}
+		}
+	}
+
+	LandmarkTable::LandmarkTable()
+		: tileCount(0), checksum(0)
+	{
+	}
+
+	void LandmarkTable::clear()
+	{
+		landmarks.clear();
+		narrowCosts.clear();
+		wideCosts.clear();
+		tileCount = 0;
+		checksum = 0;
+	}
+
+	void LandmarkTable::SelectLandmarks(HexGraph const& graph, int count)
+	{
+		int const tiles = graph.getTileCount();
+
+		// Start from the tile farthest from the first passable tile, which lands on the rim
+		int seed = -1;
+		for (int i = 0; i < tiles && seed < 0; ++i)
+		{
+			if (graph.isPassable(i))
+				seed = i;
+		}
+		if (seed < 0)
+			return;
+
+		std::vector<int> local;
+		SweepHops(graph, seed, local);
+		for (int i = 0; i < tiles; ++i)
+		{
+			if (local[i] != UNREACHED_HOPS && local[i] > local[seed])
+				seed = i;
+		}
+
+		// Fewest moves from any landmark picked so far
+		std::vector<int> hops;
+		landmarks.push_back(seed);
+		SweepHops(graph, seed, hops);
+
+		while (static_cast<int>(landmarks.size()) < count)
+		{
+			// Tiles no landmark reaches count as the farthest of all
+			int best = -1;
+			for (int i = 0; i < tiles; ++i)
+			{
+				if (graph.isPassable(i) && (best < 0 || hops[i] > hops[best]))
+					best = i;
+			}
+			if (hops[best] == 0)
+				break;
+
+			landmarks.push_back(best);
+			SweepHops(graph, best, local);
+			for (int i = 0; i < tiles; ++i)
+			{
+				if (local[i] < hops[i])
+					hops[i] = local[i];
+			}
+		}
+	}
+
+	void LandmarkTable::build(HexGraph const& graph, int count, unsigned int threadCount)
+	{
+		clear();
+		if (count <= 0)
+			return;
+
+		SelectLandmarks(graph, count);
+		if (landmarks.empty())
+			return;
+
+		int const landmarkCount = static_cast<int>(landmarks.size());
+		tileCount = graph.getTileCount();
+		checksum = graph.getChecksum();
+
+		// One Dijkstra search per landmark, each on its own thread
+		std::vector<std::vector<unsigned int> > costs(landmarkCount);
+		parallelFor(landmarkCount, [&](int l, unsigned int)
+		{
+			graph.computeCosts(landmarks[l], costs[l]);
+		}, threadCount);
+
+		unsigned int largest = 0;
+		for (int l = 0; l < landmarkCount; ++l)
+		{
+			for (int i = 0; i < tileCount; ++i)
+			{
+				if (costs[l][i] != HexGraph::INFINITE_COST && costs[l][i] > largest)
+					largest = costs[l][i];
+			}
+		}
+
+		size_t const entries = static_cast<size_t>(tileCount) * landmarkCount;
+		if (largest < NARROW_UNREACHED)
+		{
+			narrowCosts.resize(entries);
+			for (int i = 0; i < tileCount; ++i)
+			{
+				for (int l = 0; l < landmarkCount; ++l)
+				{
+					unsigned int cost = costs[l][i];
+					narrowCosts[static_cast<size_t>(i) * landmarkCount + l] =
+						cost == HexGraph::INFINITE_COST
+						? NARROW_UNREACHED
+						: static_cast<unsigned short>(cost);
+				}
+			}
+		}
+		else
+		{
+			wideCosts.resize(entries);
+			for (int i = 0; i < tileCount; ++i)
+			{
+				for (int l = 0; l < landmarkCount; ++l)
+					wideCosts[static_cast<size_t>(i) * landmarkCount + l] = costs[l][i];
+			}
+		}
+	}
+
+	unsigned int LandmarkTable::estimate(HexGraph const& graph, int from, int to) const
+	{
+		int const landmarkCount = static_cast<int>(landmarks.size());
+		long long const weightShift =
+			static_cast<long long>(graph.getWeight(to)) - graph.getWeight(from);
+		long long best = 0;
+
+		for (int l = 0; l < landmarkCount; ++l)
+		{
+			unsigned int fromCost = getCost(l, from);
+			unsigned int toCost = getCost(l, to);
+			if (fromCost == HexGraph::INFINITE_COST || toCost == HexGraph::INFINITE_COST)
+				continue;
+
+			long long forward = static_cast<long long>(toCost) - fromCost;
+			long long backward = -forward + weightShift;
+
+			if (forward > best)
+				best = forward;
+			if (backward > best)
+				best = backward;
+		}
+
+		return static_cast<unsigned int>(best);
+	}
+
+	bool LandmarkTable::save(char const* fileName) const
+	{
+		if (landmarks.empty())
+			return false;
+
+		std::ofstream output(fileName, std::ios::binary);
+		if (!output.good())
+			return false;
+
+		int landmarkCount = static_cast<int>(landmarks.size());
+		int wide = isWide() ? 1 : 0;
+
+		output.write(LANDMARK_FILE_TAG, sizeof(LANDMARK_FILE_TAG));
+		output.write(reinterpret_cast<char const*>(&tileCount), sizeof(tileCount));
+		output.write(reinterpret_cast<char const*>(&checksum), sizeof(checksum));
+		output.write(reinterpret_cast<char const*>(&landmarkCount), sizeof(landmarkCount));
+		output.write(reinterpret_cast<char const*>(&wide), sizeof(wide));
+		output.write(reinterpret_cast<char const*>(&landmarks[0]),
+			landmarkCount * sizeof(int));
+
+		if (wide)
+			output.write(reinterpret_cast<char const*>(&wideCosts[0]),
+				wideCosts.size() * sizeof(unsigned int));
+		else
+			output.write(reinterpret_cast<char const*>(&narrowCosts[0]),
+				narrowCosts.size() * sizeof(unsigned short));
+
+		return output.good();
+	}
+
+	bool LandmarkTable::load(char const* fileName, HexGraph const& graph)
+	{
+		clear();
+
+		std::ifstream input(fileName, std::ios::binary);
+		if (!input.good())
+			return false;
+
+		char tag[sizeof(LANDMARK_FILE_TAG)];
+		int fileTileCount = 0;
+		unsigned int fileChecksum = 0;
+		int landmarkCount = 0;
+		int wide = 0;
+
+		input.read(tag, sizeof(tag));
+		input.read(reinterpret_cast<char*>(&fileTileCount), sizeof(fileTileCount));
+		input.read(reinterpret_cast<char*>(&fileChecksum), sizeof(fileChecksum));
+		input.read(reinterpret_cast<char*>(&landmarkCount), sizeof(landmarkCount));
+		input.read(reinterpret_cast<char*>(&wide), sizeof(wide));
+
+		if (!input.good() || std::memcmp(tag, LANDMARK_FILE_TAG, sizeof(tag)) != 0
+			|| fileTileCount != graph.getTileCount() || fileChecksum != graph.getChecksum()
+			|| landmarkCount <= 0)
+			return false;
+
+		landmarks.resize(landmarkCount);
+		input.read(reinterpret_cast<char*>(&landmarks[0]), landmarkCount * sizeof(int));
+
+		size_t const entries = static_cast<size_t>(fileTileCount) * landmarkCount;
+		if (wide)
+		{
+			wideCosts.resize(entries);
+			input.read(reinterpret_cast<char*>(&wideCosts[0]), entries * sizeof(unsigned int));
+		}
+		else
+		{
+			narrowCosts.resize(entries);
+			input.read(reinterpret_cast<char*>(&narrowCosts[0]),
+				entries * sizeof(unsigned short));
+		}
+
+		if (!input.good())
+		{
+			clear();
+			return false;
+		}
+
+		tileCount = fileTileCount;
+		checksum = fileChecksum;
+		return true;
+	}
+}}  // namespace fullsail_ai::algorithms
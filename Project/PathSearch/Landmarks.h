@@ -0,0 +1,113 @@
+//! \file Landmarks.h
+//! \brief Defines the fullsail_ai::algorithms::LandmarkTable class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_LANDMARKS_H_
+#define _FULLSAIL_AI_PATH_PLANNER_LANDMARKS_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Precomputed landmark distances for the ALT (A*, landmarks, triangle inequality)
+	//! heuristic.
+	//!
+	//! For each landmark L the table holds the cost d(L, v) of the cheapest path from L to
+	//! every tile v.  Because moving onto a tile costs that tile's weight, the reverse cost is
+	//! d(v, L) = d(L, v) + w(L) - w(v), so one table per landmark bounds both directions:
+	//!
+	//!   d(v, t) >= d(L, t) - d(L, v)
+	//!   d(v, t) >= d(L, v) - d(L, t) + w(t) - w(v)
+	//!
+	//! Costs are stored tile-major (all landmarks of a tile are adjacent) as 16-bit integers
+	//! when the largest cost fits, and as 32-bit integers otherwise.
+	class LandmarkTable
+	{
+		std::vector<int> landmarks;
+		std::vector<unsigned short> narrowCosts;
+		std::vector<unsigned int> wideCosts;
+		int tileCount;
+		unsigned int checksum;
+
+		static const unsigned short NARROW_UNREACHED = 0xFFFFu;
+
+		//! \brief Picks landmarks by farthest-point selection over hop counts.
+		void SelectLandmarks(HexGraph const& graph, int count);
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT LandmarkTable();
+
+		//! \brief Selects landmarks and computes their cost tables.
+		//!
+		//! Landmarks are picked one at a time as the passable tile farthest (in moves) from all
+		//! landmarks picked so far, which also places one landmark in every disconnected region
+		//! before doubling up.  The weighted cost tables are then computed with one Dijkstra
+		//! search per landmark, spread across threads.
+		//!
+		//! \param   graph        the graph to preprocess.
+		//! \param   count        the number of landmarks to pick.
+		//! \param   threadCount  the number of threads, or 0 to use every hardware thread.
+		DLLEXPORT void build(HexGraph const& graph, int count, unsigned int threadCount = 0);
+
+		//! \brief Releases the tables.
+		DLLEXPORT void clear();
+
+		//! \brief Returns true if and only if the tables were built for the specified graph.
+		inline bool isValidFor(HexGraph const& graph) const
+		{
+			return !landmarks.empty() && tileCount == graph.getTileCount()
+				&& checksum == graph.getChecksum();
+		}
+
+		inline int getLandmarkCount() const
+		{
+			return static_cast<int>(landmarks.size());
+		}
+
+		//! \brief Returns the tile index of the specified landmark.
+		inline int getLandmark(int landmark) const
+		{
+			return landmarks[landmark];
+		}
+
+		//! \brief Returns true if the tables use 32-bit entries.
+		inline bool isWide() const
+		{
+			return !wideCosts.empty();
+		}
+
+		//! \brief Returns d(landmark, index), or <code>HexGraph::INFINITE_COST</code> if the
+		//! tile cannot be reached from the landmark.
+		inline unsigned int getCost(int landmark, int index) const
+		{
+			size_t slot = static_cast<size_t>(index) * landmarks.size() + landmark;
+
+			if (!wideCosts.empty())
+				return wideCosts[slot];
+
+			unsigned short cost = narrowCosts[slot];
+			return cost == NARROW_UNREACHED ? HexGraph::INFINITE_COST : cost;
+		}
+
+		//! \brief Returns the largest landmark lower bound on the cost from one tile to another.
+		//!
+		//! Landmarks that cannot reach both tiles are ignored.
+		DLLEXPORT unsigned int estimate(HexGraph const& graph, int from, int to) const;
+
+		//! \brief Writes the landmarks and their tables to a binary file.
+		//!
+		//! \return  true if the file was written.
+		DLLEXPORT bool save(char const* fileName) const;
+
+		//! \brief Reads landmarks and tables written by <code>save()</code>.
+		//!
+		//! The file is rejected if it was built for a map of a different size or with
+		//! different weights.
+		//!
+		//! \return  true if the tables were loaded and match the graph.
+		DLLEXPORT bool load(char const* fileName, HexGraph const& graph);
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_LANDMARKS_H_
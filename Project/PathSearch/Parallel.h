@@ -0,0 +1,88 @@
+//! \file Parallel.h
+//! \brief Defines the fullsail_ai::algorithms::parallelFor function template and the
+//! fullsail_ai::algorithms::SpinBarrier class.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_PARALLEL_H_
+#define _FULLSAIL_AI_PATH_PLANNER_PARALLEL_H_
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Returns the number of worker threads to use when none is specified.
+	inline unsigned int getDefaultThreadCount()
+	{
+		unsigned int count = std::thread::hardware_concurrency();
+		return count ? count : 1;
+	}
+
+	//! \brief Invokes <code>body(i, worker)</code> for every <code>i</code> in
+	//! <code>[0, count)</code>, spreading the work over several threads.
+	//!
+	//! Items are handed out one at a time, so uneven items still balance.  The calling thread
+	//! is used as worker 0, and the call returns once every item is done.
+	//!
+	//! \param   count        the number of items.
+	//! \param   body         callable taking the item index and the worker index.
+	//! \param   threadCount  the number of workers, or 0 to use every hardware thread.
+	template <class Body>
+	void parallelFor(int count, Body body, unsigned int threadCount = 0)
+	{
+		if (threadCount == 0)
+			threadCount = getDefaultThreadCount();
+		if (threadCount > static_cast<unsigned int>(count))
+			threadCount = count > 0 ? count : 1;
+
+		std::atomic<int> next(0);
+		auto work = [&](unsigned int worker)
+		{
+			for (int i = next++; i < count; i = next++)
+				body(i, worker);
+		};
+
+		std::vector<std::thread> workers;
+		for (unsigned int t = 1; t < threadCount; ++t)
+			workers.push_back(std::thread(work, t));
+
+		work(0);
+
+		for (size_t t = 0; t < workers.size(); ++t)
+			workers[t].join();
+	}
+
+	//! \brief Reusable barrier for a fixed group of threads that meet many times in a row.
+	//!
+	//! Waiting threads spin, yielding their time slice, instead of sleeping, since the phases
+	//! between meetings are short.  Everything a thread wrote before <code>wait()</code> is
+	//! visible to every other thread after it.
+	class SpinBarrier
+	{
+		unsigned int const threadCount;
+		std::atomic<unsigned int> waiting;
+		std::atomic<unsigned int> generation;
+
+	public:
+		explicit SpinBarrier(unsigned int _threadCount)
+			: threadCount(_threadCount), waiting(0), generation(0)
+		{
+		}
+
+		//! \brief Blocks until every thread of the group has called <code>wait()</code>.
+		void wait()
+		{
+			unsigned int current = generation.load(std::memory_order_acquire);
+			if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == threadCount)
+			{
+				waiting.store(0, std::memory_order_relaxed);
+				generation.fetch_add(1, std::memory_order_acq_rel);
+				return;
+			}
+
+			while (generation.load(std::memory_order_acquire) == current)
+				std::this_thread::yield();
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_PARALLEL_H_
@@ -0,0 +1,321 @@
+#include <algorithm>
+#include "PathCache.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		// Rough cost of the hash map nodes behind each path, beyond the entry itself
+		unsigned int const INDEX_OVERHEAD = 32;
+
+		double MicrosecondsSince(PathCache::Clock::time_point begin)
+		{
+			return std::chrono::duration<double, std::micro>(
+				PathCache::Clock::now() - begin).count();
+		}
+	}
+
+	PathCache::PathCache(unsigned int _byteBudget)
+		: newest(-1), oldest(-1), byteBudget(_byteBudget), byteCount(0)
+	{
+		resetStats();
+	}
+
+	void PathCache::setByteBudget(HexGraph const& graph, unsigned int _byteBudget)
+	{
+		byteBudget = _byteBudget;
+		EvictToFit(graph);
+	}
+
+	void PathCache::Unlink(int id)
+	{
+		Entry& entry = entries[id];
+
+		if (entry.previous >= 0)
+			entries[entry.previous].next = entry.next;
+		else
+			newest = entry.next;
+
+		if (entry.next >= 0)
+			entries[entry.next].previous = entry.previous;
+		else
+			oldest = entry.previous;
+
+		entry.previous = entry.next = -1;
+	}
+
+	void PathCache::PushNewest(int id)
+	{
+		Entry& entry = entries[id];
+		entry.previous = -1;
+		entry.next = newest;
+
+		if (newest >= 0)
+			entries[newest].previous = id;
+		else
+			oldest = id;
+
+		newest = id;
+	}
+
+	void PathCache::Remove(HexGraph const& graph, int id)
+	{
+		Entry& entry = entries[id];
+
+		int tile = entry.path.getStart();
+		for (int move = 0; ; ++move)
+		{
+			auto found = tilePaths.find(tile);
+			if (found != tilePaths.end())
+			{
+				std::vector<int>& ids = found->second;
+				auto position = std::find(ids.begin(), ids.end(), id);
+				if (position != ids.end())
+				{
+					*position = ids.back();
+					ids.pop_back();
+				}
+				if (ids.empty())
+					tilePaths.erase(found);
+			}
+
+			if (move == entry.path.getMoveCount())
+				break;
+			tile = graph.getAdjacent(tile, entry.path.getDirection(move));
+		}
+
+		entryIds.erase(entry.key);
+		Unlink(id);
+		byteCount -= entry.bytes;
+		entry.path.clear();
+		freeIds.push_back(id);
+	}
+
+	void PathCache::EvictToFit(HexGraph const& graph)
+	{
+		while (byteCount > byteBudget && oldest >= 0)
+		{
+			Remove(graph, oldest);
+			++stats.evictionCount;
+		}
+	}
+
+	bool PathCache::FindSpan(HexGraph const& graph, Entry const& entry, int from, int to,
+		int& fromMove, int& toMove) const
+	{
+		fromMove = -1;
+
+		int tile = entry.path.getStart();
+		for (int move = 0; ; ++move)
+		{
+			if (fromMove < 0 && tile == from)
+				fromMove = move;
+			if (fromMove >= 0 && tile == to)
+			{
+				toMove = move;
+				return true;
+			}
+
+			if (move == entry.path.getMoveCount())
+				return false;
+			tile = graph.getAdjacent(tile, entry.path.getDirection(move));
+		}
+	}
+
+	bool PathCache::find(HexGraph const& graph, int start, int goal, unsigned int profile,
+		std::vector<Tile const*>& path)
+	{
+		Clock::time_point begin = Clock::now();
+		++stats.lookupCount;
+
+		Key key = { start, goal, profile };
+		int id = -1;
+		int fromMove = 0;
+		int toMove = 0;
+
+		auto exact = entryIds.find(key);
+		if (exact != entryIds.end())
+		{
+			id = exact->second;
+			toMove = entries[id].path.getMoveCount();
+		}
+		else
+		{
+			auto crossing = tilePaths.find(start);
+			if (crossing != tilePaths.end())
+			{
+				std::vector<int> const& ids = crossing->second;
+				for (int i = 0; i < static_cast<int>(ids.size()) && id < 0; ++i)
+				{
+					Entry const& entry = entries[ids[i]];
+					if (entry.key.profile == profile
+						&& FindSpan(graph, entry, start, goal, fromMove, toMove))
+						id = ids[i];
+				}
+			}
+		}
+
+		if (id < 0)
+		{
+			stats.lookupMicroseconds += MicrosecondsSince(begin);
+			return false;
+		}
+
+		Entry const& entry = entries[id];
+
+		path.clear();
+		int tile = entry.path.getStart();
+		for (int move = 0; move < toMove; ++move)
+		{
+			if (move >= fromMove)
+				path.push_back(graph.getTile(tile));
+			tile = graph.getAdjacent(tile, entry.path.getDirection(move));
+		}
+		path.push_back(graph.getTile(tile));
+		std::reverse(path.begin(), path.end());
+
+		Unlink(id);
+		PushNewest(id);
+
+		// Assume the search time scales with the part of the path used
+		double estimate = entry.searchMicroseconds;
+		if (entry.path.getMoveCount() > 0)
+			estimate *= static_cast<double>(toMove - fromMove) / entry.path.getMoveCount();
+
+		double elapsed = MicrosecondsSince(begin);
+		++stats.hitCount;
+		if (exact == entryIds.end())
+			++stats.subpathHitCount;
+		stats.lookupMicroseconds += elapsed;
+		stats.savedMicroseconds += estimate - elapsed;
+		return true;
+	}
+
+	void PathCache::insert(HexGraph const& graph, std::vector<Tile const*> const& path,
+		unsigned int profile, double searchMicroseconds)
+	{
+		if (path.empty())
+			return;
+
+		Key key = { graph.toIndex(path.back()), graph.toIndex(path.front()), profile };
+		auto existing = entryIds.find(key);
+		if (existing != entryIds.end())
+		{
+			Unlink(existing->second);
+			PushNewest(existing->second);
+			return;
+		}
+
+		PathCode code;
+		if (!code.encode(graph, path))
+			return;
+
+		int const moveCount = code.getMoveCount();
+		unsigned int bytes = sizeof(Entry) + INDEX_OVERHEAD
+			+ code.getWordCount() * sizeof(unsigned int) + (moveCount + 1) * sizeof(int);
+		if (bytes > byteBudget)
+			return;
+
+		int id;
+		if (!freeIds.empty())
+		{
+			id = freeIds.back();
+			freeIds.pop_back();
+		}
+		else
+		{
+			id = static_cast<int>(entries.size());
+			entries.push_back(Entry());
+		}
+
+		Entry& entry = entries[id];
+		entry.key = key;
+		entry.path = code;
+		entry.searchMicroseconds = searchMicroseconds;
+		entry.bytes = bytes;
+
+		entryIds[key] = id;
+		for (int i = 0; i <= moveCount; ++i)
+			tilePaths[graph.toIndex(path[i])].push_back(id);
+
+		PushNewest(id);
+		byteCount += bytes;
+		EvictToFit(graph);
+	}
+
+	bool PathCache::findPath(PathSearch& search, int start, int goal, unsigned int profile,
+		std::vector<Tile const*>& path)
+	{
+		HexGraph const& graph = search.getGraph();
+
+		// The search would not even start from or toward a wall
+		if (start < 0 || start >= graph.getTileCount() || !graph.isPassable(start)
+			|| goal < 0 || goal >= graph.getTileCount() || !graph.isPassable(goal))
+		{
+			path.clear();
+			return false;
+		}
+
+		if (find(graph, start, goal, profile, path))
+			return true;
+
+		Clock::time_point begin = Clock::now();
+		search.enter(graph.getRow(start), graph.getColumn(start),
+			graph.getRow(goal), graph.getColumn(goal));
+		search.update(0x7FFFFFFF);
+
+		bool found = search.hasSolution();
+		// A path found after pruning or under an inflated weight may not be cheapest, and
+		// neither may its subpaths
+		bool optimal = search.getStatus() == PathSearch::SEARCH_FOUND
+			&& search.getSuboptimalityBound() == 1;
+		if (found)
+			path = search.getSolution();
+		else
+			path.clear();
+		search.exit();
+
+		double elapsed = MicrosecondsSince(begin);
+		stats.searchMicroseconds += elapsed;
+
+		if (found && optimal)
+			insert(graph, path, profile, elapsed);
+		return found;
+	}
+
+	void PathCache::invalidateTile(HexGraph const& graph, int tile)
+	{
+		auto crossing = tilePaths.find(tile);
+		if (crossing == tilePaths.end())
+			return;
+
+		// Removing a path edits the list being walked
+		std::vector<int> ids(crossing->second);
+		for (int i = 0; i < static_cast<int>(ids.size()); ++i)
+			Remove(graph, ids[i]);
+
+		stats.invalidationCount += static_cast<unsigned int>(ids.size());
+	}
+
+	void PathCache::clear()
+	{
+		entries.clear();
+		freeIds.clear();
+		entryIds.clear();
+		tilePaths.clear();
+		newest = oldest = -1;
+		byteCount = 0;
+	}
+
+	void PathCache::resetStats()
+	{
+		stats.lookupCount = 0;
+		stats.hitCount = 0;
+		stats.subpathHitCount = 0;
+		stats.evictionCount = 0;
+		stats.invalidationCount = 0;
+		stats.lookupMicroseconds = 0;
+		stats.searchMicroseconds = 0;
+		stats.savedMicroseconds = 0;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,198 @@
+//! \file PathCache.h
+//! \brief Defines the fullsail_ai::algorithms::PathCache class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_PATH_CACHE_H_
+#define _FULLSAIL_AI_PATH_PLANNER_PATH_CACHE_H_
+
+#include <chrono>
+#include <vector>
+#include <unordered_map>
+#include "HexGraph.h"
+#include "PathSearch.h"
+#include "PathCode.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Remembers recent paths so that repeated and overlapping queries skip the search.
+	//!
+	//! Paths are keyed by start, goal and cost profile, a number the caller picks for each
+	//! combination of costs it searches with, such as one per unit class or overlay.  Each
+	//! path is kept as a <code>PathCode</code>, about three bits per move.
+	//!
+	//! Every part of a cheapest path is itself a cheapest path, so a cached path from A to B
+	//! also answers a query between any two of its tiles taken in path order, in particular
+	//! from any tile on it to B.  A reverse index from tiles to the paths crossing them finds
+	//! those paths, and drops exactly the paths that cross a changed tile.
+	//!
+	//! Only cheapest paths may be cached.  <code>findPath()</code> caches a path only when
+	//! the search proved it cheapest: it ended with <code>PathSearch::SEARCH_FOUND</code> at
+	//! a suboptimality bound of 1, which holds because both of its heuristics never
+	//! overestimate.
+	//!
+	//! The cache holds at most a set number of bytes, counting the index, and evicts the
+	//! least recently used paths to stay under it.
+	class PathCache
+	{
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		//! \brief Counters since construction or <code>resetStats()</code>.
+		struct Stats
+		{
+			unsigned int lookupCount;
+			unsigned int hitCount;
+			//! Hits answered by part of a longer path; included in <code>hitCount</code>.
+			unsigned int subpathHitCount;
+			unsigned int evictionCount;
+			unsigned int invalidationCount;
+			//! Time spent in lookups, hits and misses alike.
+			double lookupMicroseconds;
+			//! Time spent searching on misses, as reported to <code>insert()</code>.
+			double searchMicroseconds;
+			//! Estimated search time the hits avoided, less the time spent looking up.
+			double savedMicroseconds;
+
+			//! \brief Returns the fraction of lookups that hit, or zero before the first.
+			inline double getHitRate() const
+			{
+				return lookupCount == 0 ? 0 : static_cast<double>(hitCount) / lookupCount;
+			}
+		};
+
+	private:
+		struct Key
+		{
+			int start;
+			int goal;
+			unsigned int profile;
+
+			inline bool operator==(Key const& other) const
+			{
+				return start == other.start && goal == other.goal
+					&& profile == other.profile;
+			}
+		};
+
+		struct KeyHash
+		{
+			inline std::size_t operator()(Key const& key) const
+			{
+				return (static_cast<std::size_t>(key.start) * 2654435761u)
+					^ (static_cast<std::size_t>(key.goal) * 40503u)
+					^ (static_cast<std::size_t>(key.profile) << 7);
+			}
+		};
+
+		struct Entry
+		{
+			Key key;
+			PathCode path;
+			double searchMicroseconds;
+			unsigned int bytes;
+			// Neighbors in recency order, -1 at the ends; previous is more recent
+			int previous;
+			int next;
+		};
+
+		std::vector<Entry> entries;
+		std::vector<int> freeIds;
+		std::unordered_map<Key, int, KeyHash> entryIds;
+		// Ids of the paths crossing each tile, start and goal included
+		std::unordered_map<int, std::vector<int> > tilePaths;
+		int newest;
+		int oldest;
+		unsigned int byteBudget;
+		unsigned int byteCount;
+		Stats stats;
+
+		void Unlink(int id);
+		void PushNewest(int id);
+		void Remove(HexGraph const& graph, int id);
+		void EvictToFit(HexGraph const& graph);
+
+		//! \brief Finds the positions of two tiles on a cached path.
+		//!
+		//! \return  true if both lie on the path, the first no later than the second.
+		bool FindSpan(HexGraph const& graph, Entry const& entry, int from, int to,
+			int& fromMove, int& toMove) const;
+
+	public:
+		//! \brief Creates an empty cache.
+		//!
+		//! \param   _byteBudget  the most memory the paths and their index may take.
+		DLLEXPORT explicit PathCache(unsigned int _byteBudget = 1u << 20);
+
+		//! \brief Changes the byte budget, evicting paths if the cache no longer fits.
+		//!
+		//! \param   graph  the graph of the cached paths.
+		DLLEXPORT void setByteBudget(HexGraph const& graph, unsigned int _byteBudget);
+
+		//! \brief Looks for a cached path, or a cached path that passes through both tiles.
+		//!
+		//! \param   graph    the graph of the cached paths.
+		//! \param   start    index of the tile to start from.
+		//! \param   goal     index of the tile to reach.
+		//! \param   profile  the cost profile of the query.
+		//! \param   path     receives the tiles ordered like
+		//!                   <code>PathSearch::getSolution()</code>, goal first, on a hit.
+		//! \return  true on a hit.
+		DLLEXPORT bool find(HexGraph const& graph, int start, int goal, unsigned int profile,
+			std::vector<Tile const*>& path);
+
+		//! \brief Caches a path found by a search.
+		//!
+		//! \param   graph               the graph the path lies on.
+		//! \param   path                the path, goal first, as from
+		//!                              <code>PathSearch::getSolution()</code>; must be a
+		//!                              cheapest path under the profile.
+		//! \param   profile             the cost profile of the search.
+		//! \param   searchMicroseconds  how long the search took, to estimate what hits
+		//!                              save.
+		DLLEXPORT void insert(HexGraph const& graph, std::vector<Tile const*> const& path,
+			unsigned int profile, double searchMicroseconds);
+
+		//! \brief Answers a query from the cache or, on a miss, runs the search to completion
+		//! and caches its path if it is proven cheapest; a degraded path is returned but not
+		//! cached.
+		//!
+		//! \param   search   an initialized search, left reset afterwards.
+		//! \param   start    index of the tile to start from.
+		//! \param   goal     index of the tile to reach.
+		//! \param   profile  the cost profile the search is set up with.
+		//! \param   path     receives the path, goal first; empty if there is none.
+		//! \return  true if there is a path.
+		DLLEXPORT bool findPath(PathSearch& search, int start, int goal, unsigned int profile,
+			std::vector<Tile const*>& path);
+
+		//! \brief Drops every cached path that crosses a tile whose weight changed.
+		//!
+		//! A tile that became cheaper or opened may also offer a shorter route to paths
+		//! that do not cross it; call <code>clear()</code> if those must stay optimal.
+		DLLEXPORT void invalidateTile(HexGraph const& graph, int tile);
+
+		//! \brief Drops every cached path.
+		DLLEXPORT void clear();
+
+		//! \brief Sets all counters to zero.
+		DLLEXPORT void resetStats();
+
+		inline Stats const& getStats() const
+		{
+			return stats;
+		}
+
+		//! \brief Returns the memory taken by the paths and their index, as counted against
+		//! the budget.
+		inline unsigned int getByteCount() const
+		{
+			return byteCount;
+		}
+
+		inline int getPathCount() const
+		{
+			return static_cast<int>(entryIds.size());
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_PATH_CACHE_H_
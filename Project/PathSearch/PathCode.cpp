@@ -0,0 +1,120 @@
+#include "PathCode.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	const int PathCode::CODES_PER_WORD;
+	const int PathCode::BITS_PER_CODE;
+
+	PathCode::PathCode()
+		: start(-1), moveCount(0)
+	{
+	}
+
+	void PathCode::clear()
+	{
+		start = -1;
+		moveCount = 0;
+		words.clear();
+	}
+
+	void PathCode::reset(int _start, int _moveCount)
+	{
+		start = _start;
+		moveCount = _moveCount;
+		words.assign((moveCount + CODES_PER_WORD - 1) / CODES_PER_WORD, 0);
+	}
+
+	void PathCode::assign(int _start, int _moveCount, unsigned int const* _words)
+	{
+		reset(_start, _moveCount);
+		for (int w = 0; w < static_cast<int>(words.size()); ++w)
+			words[w] = _words[w];
+	}
+
+	bool PathCode::encode(HexGraph const& graph, std::vector<Tile const*> const& path)
+	{
+		if (path.empty())
+		{
+			clear();
+			return true;
+		}
+
+		int const last = static_cast<int>(path.size()) - 1;
+		reset(graph.toIndex(path[last]), last);
+
+		for (int move = 0; move < last; ++move)
+		{
+			int direction = graph.getDirection(graph.toIndex(path[last - move]),
+				graph.toIndex(path[last - move - 1]));
+			if (direction < 0)
+			{
+				clear();
+				return false;
+			}
+			setDirection(move, direction);
+		}
+
+		return true;
+	}
+
+	bool PathCode::encode(HexGraph const& graph, int const* tiles, int count)
+	{
+		if (count <= 0)
+		{
+			clear();
+			return true;
+		}
+
+		reset(tiles[0], count - 1);
+
+		for (int move = 0; move + 1 < count; ++move)
+		{
+			int direction = graph.getDirection(tiles[move], tiles[move + 1]);
+			if (direction < 0)
+			{
+				clear();
+				return false;
+			}
+			setDirection(move, direction);
+		}
+
+		return true;
+	}
+
+	void PathCode::append(int direction)
+	{
+		if (moveCount % CODES_PER_WORD == 0)
+			words.push_back(0);
+		setDirection(moveCount++, direction);
+	}
+
+	int PathCode::decode(HexGraph const& graph, int* tiles, int capacity) const
+	{
+		int count = getTileCount();
+		if (count <= capacity)
+			decode(graph, tiles);
+		return count;
+	}
+
+	int PathCode::decodeCoordinates(HexGraph const& graph, double* coordinates,
+		int capacity) const
+	{
+		int count = getTileCount();
+		if (count > capacity || count == 0)
+			return count;
+
+		int tile = start;
+		for (int move = 0; ; ++move)
+		{
+			Tile const* current = graph.getTile(tile);
+			*coordinates++ = current->getXCoordinate();
+			*coordinates++ = current->getYCoordinate();
+
+			if (move == moveCount)
+				break;
+			tile = graph.getAdjacent(tile, getDirection(move));
+		}
+
+		return count;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,163 @@
+//! \file PathCode.h
+//! \brief Defines the fullsail_ai::algorithms::PathCode class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_PATH_CODE_H_
+#define _FULLSAIL_AI_PATH_PLANNER_PATH_CODE_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../TileSystem/Tile.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief A path stored as its start tile and a 3-bit direction code per move.
+	//!
+	//! Ten codes are packed into each 32-bit word, so a path of <code>n</code> moves takes
+	//! <code>4 * ceil(n / 10)</code> bytes after the start index, a tenth of the four bytes per
+	//! tile that a vector of tile pointers holds in the Win32 build.  Codes never straddle
+	//! words, so decoding is a shift and a mask per move.  The packed words can be stored or
+	//! sent as they are and restored with <code>assign()</code>.
+	//!
+	//! Moves run from the start to the goal, the reverse of
+	//! <code>PathSearch::getSolution()</code>.
+	class PathCode
+	{
+		int start;
+		int moveCount;
+		std::vector<unsigned int> words;
+
+	public:
+		static const int CODES_PER_WORD = 10;
+		static const int BITS_PER_CODE = 3;
+
+		//! \brief Creates an empty code, with no start tile.
+		DLLEXPORT PathCode();
+
+		//! \brief Empties the code.
+		DLLEXPORT void clear();
+
+		//! \brief Sets the start tile and the number of moves, leaving every move in
+		//! direction 0 until <code>setDirection()</code> is called.
+		DLLEXPORT void reset(int _start, int _moveCount);
+
+		//! \brief Restores a code from its packed words.
+		//!
+		//! \param   _start      index of the start tile.
+		//! \param   _moveCount  the number of moves.
+		//! \param   _words      <code>getWordCount()</code> words, as from
+		//!                      <code>getWords()</code>.
+		DLLEXPORT void assign(int _start, int _moveCount, unsigned int const* _words);
+
+		//! \brief Encodes a path of tiles ordered goal first, as returned by
+		//! <code>PathSearch::getSolution()</code>.
+		//!
+		//! \return  false, leaving the code empty, if two consecutive tiles are not adjacent.
+		DLLEXPORT bool encode(HexGraph const& graph, std::vector<Tile const*> const& path);
+
+		//! \brief Encodes a path of tile indices ordered start first.
+		//!
+		//! \return  false, leaving the code empty, if two consecutive tiles are not adjacent.
+		DLLEXPORT bool encode(HexGraph const& graph, int const* tiles, int count);
+
+		//! \brief Adds a move at the goal end.
+		DLLEXPORT void append(int direction);
+
+		//! \brief Sets the direction of one move.
+		inline void setDirection(int move, int direction)
+		{
+			unsigned int& word = words[move / CODES_PER_WORD];
+			int shift = (move % CODES_PER_WORD) * BITS_PER_CODE;
+			word = (word & ~(7u << shift)) | (static_cast<unsigned int>(direction) << shift);
+		}
+
+		//! \brief Returns the direction of one move.
+		inline int getDirection(int move) const
+		{
+			return (words[move / CODES_PER_WORD] >> ((move % CODES_PER_WORD) * BITS_PER_CODE))
+				& 7;
+		}
+
+		//! \brief Returns true if the code holds no path.
+		inline bool isEmpty() const
+		{
+			return start < 0;
+		}
+
+		//! \brief Returns the index of the start tile, or -1 if the code is empty.
+		inline int getStart() const
+		{
+			return start;
+		}
+
+		inline int getMoveCount() const
+		{
+			return moveCount;
+		}
+
+		//! \brief Returns the number of tiles on the path, the start included.
+		inline int getTileCount() const
+		{
+			return start < 0 ? 0 : moveCount + 1;
+		}
+
+		//! \brief Returns the packed words, <code>NULL</code> if there are none.
+		inline unsigned int const* getWords() const
+		{
+			return words.empty() ? 0 : &words[0];
+		}
+
+		inline int getWordCount() const
+		{
+			return static_cast<int>(words.size());
+		}
+
+		//! \brief Writes the tile indices of the path, start first, to an output iterator.
+		//!
+		//! \return  the iterator past the last index written.
+		template <class OutputIterator>
+		OutputIterator decode(HexGraph const& graph, OutputIterator out) const
+		{
+			if (start < 0)
+				return out;
+
+			int tile = start;
+			*out = tile;
+			++out;
+
+			for (int w = 0, move = 0; move < moveCount; ++w)
+			{
+				unsigned int word = words[w];
+				int end = moveCount - move < CODES_PER_WORD ? moveCount : move + CODES_PER_WORD;
+
+				for (; move < end; ++move, word >>= BITS_PER_CODE)
+				{
+					tile = graph.getAdjacent(tile, word & 7);
+					*out = tile;
+					++out;
+				}
+			}
+
+			return out;
+		}
+
+		//! \brief Writes the tile indices of the path, start first, to a buffer.
+		//!
+		//! \param   tiles     the buffer.
+		//! \param   capacity  the number of indices the buffer holds.
+		//! \return  <code>getTileCount()</code>; nothing is written if that exceeds the
+		//!          capacity.
+		DLLEXPORT int decode(HexGraph const& graph, int* tiles, int capacity) const;
+
+		//! \brief Writes the world coordinates of the tile centers, start first, as
+		//! alternating x and y values.
+		//!
+		//! \param   coordinates  the buffer.
+		//! \param   capacity     the number of tiles the buffer holds, half its length.
+		//! \return  <code>getTileCount()</code>; nothing is written if that exceeds the
+		//!          capacity.
+		DLLEXPORT int decodeCoordinates(HexGraph const& graph, double* coordinates,
+			int capacity) const;
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_PATH_CODE_H_
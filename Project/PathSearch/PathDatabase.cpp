@@ -0,0 +1,403 @@
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "PathDatabase.h"
+#include "Parallel.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		char const DATABASE_FILE_TAG[4] = { 'C', 'P', 'D', '1' };
+
+		// A run packs the position of its first target above a 3-bit move
+		int const MOVE_BITS = 3;
+		unsigned int const MOVE_MASK = (1u << MOVE_BITS) - 1;
+		unsigned char const ANY_MOVE = 0xFF;
+
+		int const BUCKET_COUNT = 256;
+
+		struct FileHeader
+		{
+			char tag[4];
+			int tileCount;
+			unsigned int checksum;
+			unsigned int runCount;
+		};
+
+		// Distance along a Hilbert curve filling a side x side square, side a power of two
+		unsigned long long HilbertIndex(int side, int x, int y)
+		{
+			unsigned long long index = 0;
+
+			for (int s = side / 2; s > 0; s /= 2)
+			{
+				int rx = (x & s) > 0;
+				int ry = (y & s) > 0;
+				index += static_cast<unsigned long long>(s) * s * ((3 * rx) ^ ry);
+
+				// Rotate the quadrant so the curve stays continuous
+				if (ry == 0)
+				{
+					if (rx == 1)
+					{
+						x = side - 1 - x;
+						y = side - 1 - y;
+					}
+					std::swap(x, y);
+				}
+			}
+
+			return index;
+		}
+
+		//! First-move search scratch owned by one worker thread.
+		struct MoveScratch
+		{
+			std::vector<unsigned int> costs;
+			std::vector<unsigned char> moves;
+			std::vector<std::vector<int> > buckets;
+		};
+
+		// Dijkstra from the source with a bucket queue, labelling every tile with the first
+		// move of the cheapest path found to it.
+		void ComputeFirstMoves(HexGraph const& graph, int source, MoveScratch& scratch)
+		{
+			scratch.costs.assign(graph.getTileCount(), HexGraph::INFINITE_COST);
+			scratch.moves.assign(graph.getTileCount(), ANY_MOVE);
+			scratch.buckets.resize(BUCKET_COUNT);
+
+			int pending = 1;
+			scratch.costs[source] = 0;
+			scratch.buckets[0].push_back(source);
+
+			for (unsigned int current = 0; pending > 0; ++current)
+			{
+				std::vector<int>& bucket = scratch.buckets[current % BUCKET_COUNT];
+
+				while (!bucket.empty())
+				{
+					int tile = bucket.back();
+					bucket.pop_back();
+					--pending;
+
+					if (scratch.costs[tile] != current)
+						continue;
+
+					for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+					{
+						int neighbor = graph.getNeighbor(tile, d);
+						if (neighbor < 0)
+							continue;
+
+						unsigned int cost = current + graph.getWeight(neighbor);
+						if (cost < scratch.costs[neighbor])
+						{
+							scratch.costs[neighbor] = cost;
+							scratch.moves[neighbor] = tile == source
+								? static_cast<unsigned char>(d) : scratch.moves[tile];
+							scratch.buckets[cost % BUCKET_COUNT].push_back(neighbor);
+							++pending;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	PathDatabase::PathDatabase()
+		: positions(0), regions(0), offsets(0), runs(0)
+		, tileCount(0), checksum(0), runCount(0)
+		, fileHandle(0), mappingHandle(0), view(0), viewSize(0)
+	{
+	}
+
+	PathDatabase::~PathDatabase()
+	{
+		clear();
+	}
+
+	void PathDatabase::Unmap()
+	{
+#ifdef _WIN32
+		if (view != 0)
+			UnmapViewOfFile(view);
+		if (mappingHandle != 0)
+			CloseHandle(mappingHandle);
+		if (fileHandle != 0)
+			CloseHandle(fileHandle);
+#else
+		if (view != 0)
+			munmap(view, viewSize);
+#endif
+		fileHandle = mappingHandle = view = 0;
+		viewSize = 0;
+	}
+
+	void PathDatabase::UseOwnedStorage()
+	{
+		positions = ownedPositions.empty() ? 0 : &ownedPositions[0];
+		regions = ownedRegions.empty() ? 0 : &ownedRegions[0];
+		offsets = ownedOffsets.empty() ? 0 : &ownedOffsets[0];
+		runs = ownedRuns.empty() ? 0 : &ownedRuns[0];
+	}
+
+	void PathDatabase::clear()
+	{
+		Unmap();
+		ownedPositions.clear();
+		ownedRegions.clear();
+		ownedOffsets.clear();
+		ownedRuns.clear();
+		positions = regions = 0;
+		offsets = runs = 0;
+		tileCount = 0;
+		checksum = 0;
+		runCount = 0;
+	}
+
+	void PathDatabase::build(HexGraph const& graph, unsigned int threadCount)
+	{
+		clear();
+		if (threadCount == 0)
+			threadCount = getDefaultThreadCount();
+
+		int const tiles = graph.getTileCount();
+		int const columns = graph.getColumnCount();
+
+		// Locality-preserving target order
+		int side = 1;
+		while (side < graph.getRowCount() || side < columns)
+			side <<= 1;
+
+		std::vector<std::pair<unsigned long long, int> > keyed(tiles);
+		for (int tile = 0; tile < tiles; ++tile)
+			keyed[tile] = std::make_pair(HilbertIndex(side, tile % columns, tile / columns), tile);
+		std::sort(keyed.begin(), keyed.end());
+
+		std::vector<int> order(tiles);
+		ownedPositions.resize(tiles);
+		for (int p = 0; p < tiles; ++p)
+		{
+			order[p] = keyed[p].second;
+			ownedPositions[keyed[p].second] = p;
+		}
+
+		// Connected regions, so unreachable targets are answered without a lookup
+		ownedRegions.assign(tiles, -1);
+		std::vector<int> frontier;
+		for (int seed = 0, region = 0; seed < tiles; ++seed)
+		{
+			if (!graph.isPassable(seed) || ownedRegions[seed] >= 0)
+				continue;
+
+			ownedRegions[seed] = region;
+			frontier.assign(1, seed);
+			while (!frontier.empty())
+			{
+				int tile = frontier.back();
+				frontier.pop_back();
+				for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+				{
+					int neighbor = graph.getNeighbor(tile, d);
+					if (neighbor >= 0 && ownedRegions[neighbor] < 0)
+					{
+						ownedRegions[neighbor] = region;
+						frontier.push_back(neighbor);
+					}
+				}
+			}
+			++region;
+		}
+
+		// One search and one run-length encoding per source
+		std::vector<std::vector<unsigned int> > sourceRuns(tiles);
+		std::vector<MoveScratch> scratch(threadCount);
+
+		parallelFor(tiles, [&](int source, unsigned int worker)
+		{
+			if (!graph.isPassable(source))
+				return;
+
+			ComputeFirstMoves(graph, source, scratch[worker]);
+			std::vector<unsigned char> const& moves = scratch[worker].moves;
+			std::vector<unsigned int>& encoded = sourceRuns[source];
+			unsigned int currentMove = ANY_MOVE;
+
+			for (int p = 0; p < tiles; ++p)
+			{
+				unsigned int move = moves[order[p]];
+				if (move == ANY_MOVE || move == currentMove)
+					continue;
+
+				// The first run also covers every don't-care target before it
+				unsigned int start = encoded.empty() ? 0 : static_cast<unsigned int>(p);
+				encoded.push_back((start << MOVE_BITS) | move);
+				currentMove = move;
+			}
+		}, threadCount);
+
+		ownedOffsets.resize(tiles + 1);
+		ownedOffsets[0] = 0;
+		for (int source = 0; source < tiles; ++source)
+		{
+			ownedOffsets[source + 1] = ownedOffsets[source]
+				+ static_cast<unsigned int>(sourceRuns[source].size());
+		}
+
+		runCount = ownedOffsets[tiles];
+		ownedRuns.reserve(runCount);
+		for (int source = 0; source < tiles; ++source)
+		{
+			ownedRuns.insert(ownedRuns.end(), sourceRuns[source].begin(), sourceRuns[source].end());
+			std::vector<unsigned int>().swap(sourceRuns[source]);
+		}
+
+		tileCount = tiles;
+		checksum = graph.getChecksum();
+		UseOwnedStorage();
+	}
+
+	int PathDatabase::getFirstMove(int source, int target) const
+	{
+		if (source == target || regions[source] < 0 || regions[source] != regions[target])
+			return -1;
+
+		unsigned int const* begin = runs + offsets[source];
+		unsigned int const* end = runs + offsets[source + 1];
+		unsigned int key = (static_cast<unsigned int>(positions[target]) << MOVE_BITS) | MOVE_MASK;
+
+		// The last run starting at or before the target's position
+		unsigned int const* run = std::upper_bound(begin, end, key);
+		return static_cast<int>(*(run - 1) & MOVE_MASK);
+	}
+
+	unsigned int PathDatabase::extractPath(HexGraph const& graph, int start, int goal,
+		std::vector<Tile const*>& path) const
+	{
+		path.clear();
+		if (start != goal && getFirstMove(start, goal) < 0)
+			return HexGraph::INFINITE_COST;
+
+		unsigned int cost = 0;
+		int tile = start;
+		path.push_back(graph.getTile(tile));
+
+		while (tile != goal)
+		{
+			tile = graph.getNeighbor(tile, getFirstMove(tile, goal));
+			cost += graph.getWeight(tile);
+			path.push_back(graph.getTile(tile));
+		}
+
+		std::reverse(path.begin(), path.end());
+		return cost;
+	}
+
+	bool PathDatabase::save(char const* fileName) const
+	{
+		if (runs == 0)
+			return false;
+
+		std::ofstream output(fileName, std::ios::binary);
+		if (!output.good())
+			return false;
+
+		FileHeader header;
+		std::memcpy(header.tag, DATABASE_FILE_TAG, sizeof(header.tag));
+		header.tileCount = tileCount;
+		header.checksum = checksum;
+		header.runCount = runCount;
+
+		output.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		output.write(reinterpret_cast<char const*>(positions), tileCount * sizeof(int));
+		output.write(reinterpret_cast<char const*>(regions), tileCount * sizeof(int));
+		output.write(reinterpret_cast<char const*>(offsets),
+			(tileCount + 1) * sizeof(unsigned int));
+		output.write(reinterpret_cast<char const*>(runs), runCount * sizeof(unsigned int));
+
+		return output.good();
+	}
+
+	bool PathDatabase::load(char const* fileName, HexGraph const& graph)
+	{
+		clear();
+
+#ifdef _WIN32
+		fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL, NULL);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			fileHandle = 0;
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(FileHeader)))
+		{
+			Unmap();
+			return false;
+		}
+		viewSize = static_cast<size_t>(fileSize.QuadPart);
+
+		mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mappingHandle != 0)
+			view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+		int descriptor = open(fileName, O_RDONLY);
+		if (descriptor < 0)
+			return false;
+
+		struct stat status;
+		if (fstat(descriptor, &status) != 0
+			|| status.st_size < static_cast<off_t>(sizeof(FileHeader)))
+		{
+			close(descriptor);
+			return false;
+		}
+		viewSize = static_cast<size_t>(status.st_size);
+
+		view = mmap(0, viewSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		close(descriptor);
+		if (view == MAP_FAILED)
+			view = 0;
+#endif
+
+		if (view == 0)
+		{
+			Unmap();
+			return false;
+		}
+
+		FileHeader const* header = static_cast<FileHeader const*>(view);
+		size_t const expectedSize = sizeof(FileHeader)
+			+ static_cast<size_t>(header->tileCount) * 2 * sizeof(int)
+			+ (static_cast<size_t>(header->tileCount) + 1) * sizeof(unsigned int)
+			+ static_cast<size_t>(header->runCount) * sizeof(unsigned int);
+
+		if (std::memcmp(header->tag, DATABASE_FILE_TAG, sizeof(header->tag)) != 0
+			|| header->tileCount != graph.getTileCount()
+			|| header->checksum != graph.getChecksum() || viewSize != expectedSize)
+		{
+			Unmap();
+			return false;
+		}
+
+		tileCount = header->tileCount;
+		checksum = header->checksum;
+		runCount = header->runCount;
+		positions = reinterpret_cast<int const*>(header + 1);
+		regions = positions + tileCount;
+		offsets = reinterpret_cast<unsigned int const*>(regions + tileCount);
+		runs = offsets + tileCount + 1;
+		return true;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,113 @@
+//! \file PathDatabase.h
+//! \brief Defines the fullsail_ai::algorithms::PathDatabase class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_PATH_DATABASE_H_
+#define _FULLSAIL_AI_PATH_PLANNER_PATH_DATABASE_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Compressed path database: the first move of a cheapest path between any two
+	//! tiles.
+	//!
+	//! For every source tile the first moves toward all targets are listed in Hilbert-curve
+	//! order of the targets, so nearby targets, which usually share a first move, sit next to
+	//! each other.  Each list is run-length encoded; targets whose move does not matter (the
+	//! source itself, walls, other regions) extend whichever run they fall in.  A lookup is a
+	//! binary search over one source's runs, and a path is extracted one move at a time with
+	//! no search at all.
+	//!
+	//! A database loaded from a file is memory-mapped, so it costs no heap and only the pages
+	//! that are queried are read.
+	class PathDatabase
+	{
+		// Owned storage when built in memory
+		std::vector<int> ownedPositions;
+		std::vector<int> ownedRegions;
+		std::vector<unsigned int> ownedOffsets;
+		std::vector<unsigned int> ownedRuns;
+
+		// Views used by queries, into the owned storage or the mapped file
+		int const* positions;
+		int const* regions;
+		unsigned int const* offsets;
+		unsigned int const* runs;
+
+		int tileCount;
+		unsigned int checksum;
+		unsigned int runCount;
+
+		// Mapped file, when loaded
+		void* fileHandle;
+		void* mappingHandle;
+		void* view;
+		size_t viewSize;
+
+		void Unmap();
+		void UseOwnedStorage();
+
+		// Non-copyable: the views point into this object or its mapping
+		PathDatabase(PathDatabase const&);
+		PathDatabase& operator=(PathDatabase const&);
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT PathDatabase();
+
+		//! \brief Destructor.  Unmaps the file, if any.
+		DLLEXPORT ~PathDatabase();
+
+		//! \brief Builds the database with one search per source tile.
+		//!
+		//! \param   graph        the graph to preprocess.
+		//! \param   threadCount  the number of threads, or 0 to use every hardware thread.
+		DLLEXPORT void build(HexGraph const& graph, unsigned int threadCount = 0);
+
+		//! \brief Releases the database and unmaps its file.
+		DLLEXPORT void clear();
+
+		//! \brief Returns true if and only if the database was built for the specified graph.
+		inline bool isValidFor(HexGraph const& graph) const
+		{
+			return runs != 0 && tileCount == graph.getTileCount()
+				&& checksum == graph.getChecksum();
+		}
+
+		//! \brief Returns the total number of runs, a measure of the database size.
+		inline unsigned int getRunCount() const
+		{
+			return runCount;
+		}
+
+		//! \brief Returns the direction of the first move of a cheapest path from the source to
+		//! the target, or -1 if the tiles are the same or the target cannot be reached.
+		DLLEXPORT int getFirstMove(int source, int target) const;
+
+		//! \brief Extracts the cheapest path between two tiles one move at a time.
+		//!
+		//! \param   graph  the graph the database was built for.
+		//! \param   start  index of the start tile.
+		//! \param   goal   index of the goal tile.
+		//! \param   path   receives the tiles ordered like
+		//!                 <code>PathSearch::getSolution()</code>: goal first, start last.
+		//!                 Left empty if the goal cannot be reached.
+		//! \return  the cost of the path, or <code>HexGraph::INFINITE_COST</code>.
+		DLLEXPORT unsigned int extractPath(HexGraph const& graph, int start, int goal,
+			std::vector<Tile const*>& path) const;
+
+		//! \brief Writes the database to a binary file, usually the map file name followed
+		//! by <code>.cpd</code>.
+		//!
+		//! \return  true if the file was written.
+		DLLEXPORT bool save(char const* fileName) const;
+
+		//! \brief Memory-maps a database written by <code>save()</code>.
+		//!
+		//! \return  true if the file was mapped and matches the graph.
+		DLLEXPORT bool load(char const* fileName, HexGraph const& graph);
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_PATH_DATABASE_H_
@@ -1,8 +1,11 @@
+#include <algorithm>
 #include "PathSearch.h"
 #include <iostream>
 
 namespace fullsail_ai { namespace algorithms {
 
+	const int PathSearch::MULTI_GOAL_HEURISTIC_LIMIT;
+
 	PathSearch::PathSearch()
 	{
 		// Col, Row
@@ -45,12 +48,30 @@ namespace fullsail_ai { namespace algorithms {
 	}
 
 	void PathSearch::initialize(TileMap* _tileMap)
+	{
+		initialize(_tileMap, nullptr);
+	}
+
+	void PathSearch::initialize(TileMap* _tileMap, char const* landmarkFileName)
 	{
 		ClearContainers();
 		bestNode = nullptr;
 		tileMap = _tileMap;
 		searchDone = false;
 
+		// Learned heuristics survive a reload only if no tile got cheaper or opened
+		std::vector<unsigned char> previousWeights;
+		int previousRowCount = graph.getRowCount();
+		int previousColumnCount = graph.getColumnCount();
+		if (!learnedHeuristics.empty() && graph.isBuilt())
+			previousWeights.assign(graph.getWeights(), graph.getWeights() + graph.getTileCount());
+
+		// Precompute heuristic tables; the cost plane, if any, replaces the weights here
+		graph.build(tileMap, costPlane);
+		if (!learnedHeuristics.empty()
+			&& !WeightsOnlyRose(previousWeights, previousRowCount, previousColumnCount))
+			invalidateLearnedHeuristics();
+
 		// Create SearchNode graph
 		for (int row = 0; row < tileMap->getRowCount(); row++)
 		{
@@ -58,7 +79,7 @@ namespace fullsail_ai { namespace algorithms {
 			{
 				// Only create nodes for tiles that are traversable
 				Tile* tile = tileMap->getTile(row, col);
-				if (tile->getWeight() == 0)
+				if (!graph.isPassable(graph.toIndex(row, col)))
 					continue;
 
 				SearchNode* newSearchNode = GetSearchNode(tile);
@@ -70,7 +91,7 @@ namespace fullsail_ai { namespace algorithms {
 					Tile* adjacentTile = tileMap->getTile(
 						row + offsets[a].second, 
 						col + offsets[a].first);
-					if (adjacentTile != 0 && adjacentTile->getWeight() > 0)
+					if (adjacentTile != 0 && graph.isPassable(graph.toIndex(adjacentTile)))
 					{
 						SearchNode* adjacentSearchNode = GetSearchNode(adjacentTile);
 						newSearchNode->neighbors.push_back(adjacentSearchNode);
@@ -79,22 +100,164 @@ namespace fullsail_ai { namespace algorithms {
 			}
 		}
 
+		if (heuristic == LANDMARK_HEURISTIC
+			&& (!landmarks.isValidFor(graph) || builtLandmarkCount != landmarkCount))
+		{
+			// A saved file with another landmark count is replaced too
+			if (landmarkFileName == nullptr || !landmarks.load(landmarkFileName, graph)
+				|| landmarks.getLandmarkCount() != landmarkCount)
+			{
+				landmarks.build(graph, landmarkCount);
+				if (landmarkFileName != nullptr)
+					landmarks.save(landmarkFileName);
+			}
+			builtLandmarkCount = landmarkCount;
+		}
+
 		//debug_DrawSearchNodeConnections();
 	}
 
+	void PathSearch::setHeuristic(Heuristic _heuristic, int _landmarkCount)
+	{
+		heuristic = _heuristic;
+		landmarkCount = _landmarkCount;
+	}
+
+	bool PathSearch::saveLandmarks(char const* fileName) const
+	{
+		return landmarks.save(fileName);
+	}
+
+	bool PathSearch::loadLandmarks(char const* fileName)
+	{
+		if (!graph.isBuilt() || !landmarks.load(fileName, graph))
+			return false;
+
+		builtLandmarkCount = landmarks.getLandmarkCount();
+		return true;
+	}
+
+	void PathSearch::setCostPlane(unsigned char const* plane)
+	{
+		costPlane = plane;
+	}
+
+	void PathSearch::setCostOverlay(CostOverlay const* overlay)
+	{
+		costOverlay = overlay;
+	}
+
+	void PathSearch::setMinimumClearance(ClearanceMap const* clearance, int minimum)
+	{
+		clearanceMap = clearance;
+		minimumClearance = minimum;
+	}
+
+	void PathSearch::setAnytime(double _initialWeight, double _weightStep)
+	{
+		initialHeuristicWeight = _initialWeight > 1 ? _initialWeight : 1;
+		heuristicWeightStep = _weightStep;
+	}
+
+	void PathSearch::setAdaptive(int goalLimit)
+	{
+		learnedGoalLimit = goalLimit > 0 ? goalLimit : 0;
+		learnedHeuristic = nullptr;
+		EvictLearnedHeuristics(learnedGoalLimit);
+	}
+
+	void PathSearch::invalidateLearnedHeuristics()
+	{
+		// Stale tables are cleared when next used, so this costs nothing per goal
+		++learnedEpoch;
+		learnedHeuristic = nullptr;
+	}
+
+	size_t PathSearch::getLearnedMemoryUsage() const
+	{
+		size_t total = 0;
+		for (auto itter = learnedHeuristics.begin(); itter != learnedHeuristics.end(); ++itter)
+			total += itter->second.table.getMemoryUsage();
+		return total;
+	}
+
+	void PathSearch::setNodeBudget(int budget)
+	{
+		// Room for the start, a full expansion and something to prune
+		nodeBudget = budget <= 0 ? 0 : (std::max)(budget, 64);
+	}
+
+	void PathSearch::setDrawing(bool enabled)
+	{
+		drawing = enabled;
+	}
+
+	PathSearch::Status PathSearch::getStatus() const
+	{
+		return status;
+	}
+
+	int PathSearch::getNodeCount() const
+	{
+		return static_cast<int>(visited.size());
+	}
+
+	int PathSearch::getPrunedCount() const
+	{
+		return prunedCount;
+	}
+
 	void PathSearch::enter(int startRow, int startColumn, int goalRow, int goalColumn)
+	{
+		enter(startRow, startColumn,
+			std::vector<std::pair<int, int> >(1, std::make_pair(goalRow, goalColumn)));
+	}
+
+	void PathSearch::enter(int startRow, int startColumn,
+		std::vector<std::pair<int, int> > const& goals)
 	{
 		queue.clear();
+		searchDone = false;
+		status = SEARCH_NO_PATH;
+		prunedCount = 0;
+		heuristicWeight = initialHeuristicWeight;
+		anytimeIteration = 1;
+		inconsistentNodes.clear();
+		solutionNode = nullptr;
+		suboptimalityBound = 0;
+		goalNodes.clear();
+		goalIndices.clear();
+		learnedHeuristic = nullptr;
+
 		Tile* startTile = tileMap->getTile(startRow, startColumn);
-		Tile* goalTile = tileMap->getTile(goalRow, goalColumn);
 
 		// Ensure start and goal tiles are navigable
-		if (startTile == 0 || goalTile == 0
-			|| startTile->getWeight() == 0 || goalTile->getWeight() == 0)
+		if (startTile == 0 || !graph.isPassable(graph.toIndex(startTile)))
+		{
+			searchDone = true;
+			return;
+		}
+
+		for (size_t i = 0; i < goals.size(); ++i)
+		{
+			Tile* goalTile = tileMap->getTile(goals[i].first, goals[i].second);
+			if (goalTile == 0 || !graph.isPassable(graph.toIndex(goalTile)))
+				continue;
+
+			SearchNode* node = nodes.find(goalTile)->second;
+			if (goalIndices.insert(std::make_pair(node, static_cast<int>(i))).second)
+				goalNodes.push_back(node);
+		}
+
+		if (goalNodes.empty())
+		{
+			searchDone = true;
 			return;
+		}
 
 		// Set the goal node
-		goalNode = nodes.find(goalTile)->second;
+		goalNode = goalNodes[0];
+		learnedHeuristic = FindLearnedHeuristic();
 
 		// Create PlannerNode for start
 		SearchNode* startNode = nodes.find(startTile)->second;
@@ -104,13 +267,15 @@ namespace fullsail_ai { namespace algorithms {
 		startPNode->givenCost = 0;
 		startPNode->heuristicCost = DistanceToGoal(startPNode->searchNode->tile);
 		startPNode->nodeCost = startPNode->givenCost + (startPNode->heuristicCost * heuristicWeight);
+		status = SEARCH_RUNNING;
 
 		// Push start onto queue
 		queue.push(startPNode);
 		visited[startNode] = startPNode;
 
 		// Mark startNode as visited
-		MarkTileAsVisited(startNode->tile);
+		if (drawing)
+			MarkTileAsVisited(startNode->tile);
 		bestNode = startPNode;
 	}
 
@@ -120,23 +285,68 @@ namespace fullsail_ai { namespace algorithms {
 		// Load state from previous pause
 		while (!queue.empty() && timeslice > -1)
 		{
+			// Make room for every successor of the next expansion
+			if (nodeBudget != 0
+				&& static_cast<int>(visited.size()) + MAX_ADJACENT_NEIGHBORS > nodeBudget)
+			{
+				while (static_cast<int>(visited.size()) + MAX_ADJACENT_NEIGHBORS > nodeBudget)
+				{
+					// Every node left is needed; give up like a finished search
+					if (!PruneNodes())
+					{
+						status = SEARCH_FAILED;
+						searchDone = true;
+						queue.clear();
+						return;
+					}
+				}
+
+				if (queue.empty())
+					break;
+			}
+
 			PlannerNode* current = queue.front();
 			queue.pop();
 
 			bestNode = current;
 
-			if (current->searchNode == goalNode)
+			if (goalIndices.find(current->searchNode) != goalIndices.end())
 			{
 				// Goal Achieved
+				goalNode = current->searchNode;
+				if (heuristicWeight > 1)
+				{
+					// Anytime pass: keep the path and improve it with a lower weight
+					ImproveSolution(current);
+					--timeslice;
+					continue;
+				}
+
+				solutionNode = current;
+				suboptimalityBound = 1;
 				searchDone = true;
+				status = prunedCount == 0 ? SEARCH_FOUND : SEARCH_DEGRADED;
+				if (learnedHeuristic != nullptr && prunedCount == 0)
+					LearnHeuristic(current);
 				return;
 			}
 
+			current->closedIteration = anytimeIteration;
+
 			for (int i = 0; i < current->searchNode->neighbors.size(); ++i)
 			{
 				SearchNode* successor = current->searchNode->neighbors[i];
-				int newGivenCost = current->givenCost
-					+ successor->tile->getWeight();
+				int const successorIndex = graph.toIndex(successor->tile);
+				if (clearanceMap != nullptr && !clearanceMap->fits(successorIndex, minimumClearance))
+					continue;
+
+				// Read from the snapshot, so a cost plane applies like the tile weights
+				unsigned int stepCost = costOverlay == nullptr ? graph.getWeight(successorIndex)
+					: costOverlay->getCost(graph, successorIndex);
+				if (stepCost == HexGraph::INFINITE_COST)
+					continue;
+
+				int newGivenCost = current->givenCost + static_cast<int>(stepCost);
 
 				if (visited.find(successor) == visited.end())
 				{
@@ -161,8 +371,22 @@ namespace fullsail_ai { namespace algorithms {
 						successorNode->givenCost = newGivenCost;
 						successorNode->nodeCost = successorNode->givenCost
 							+ (successorNode->heuristicCost * heuristicWeight);
-						queue.remove(successorNode);
-						queue.push(successorNode);
+
+						if (heuristicWeight > 1
+							&& successorNode->closedIteration == anytimeIteration)
+						{
+							// Expanded during this pass: defer it to the next pass
+							if (!successorNode->inconsistent)
+							{
+								successorNode->inconsistent = true;
+								inconsistentNodes.push_back(successorNode);
+							}
+						}
+						else
+						{
+							queue.remove(successorNode);
+							queue.push(successorNode);
+						}
 					}
 				}
 			}
@@ -170,13 +394,194 @@ namespace fullsail_ai { namespace algorithms {
 			--timeslice;
 		}
 
+		// Open nodes ran out before any goal came off the queue
+		if (queue.empty() && status == SEARCH_RUNNING && solutionNode == nullptr)
+		{
+			status = prunedCount == 0 ? SEARCH_NO_PATH : SEARCH_FAILED;
+			searchDone = true;
+		}
+
+		if (drawing)
+			DrawTiles();
+	}
+
+	void PathSearch::ImproveSolution(PlannerNode* goal)
+	{
+		solutionNode = goal;
+
+		// No path can cost less than the lowest unweighted estimate still pending
+		double lowestCost = goal->givenCost;
+		std::vector<PlannerNode*> openNodes;
+		queue.enumerate(openNodes);
+		openNodes.insert(openNodes.end(), inconsistentNodes.begin(), inconsistentNodes.end());
+		for (auto itter = openNodes.begin(); itter != openNodes.end(); ++itter)
+		{
+			double cost = (*itter)->givenCost + (*itter)->heuristicCost;
+			if (cost < lowestCost)
+				lowestCost = cost;
+		}
+
+		suboptimalityBound = heuristicWeight;
+		if (lowestCost > 0 && goal->givenCost / lowestCost < suboptimalityBound)
+			suboptimalityBound = goal->givenCost / lowestCost;
+		if (suboptimalityBound < 1)
+			suboptimalityBound = 1;
+
+		heuristicWeight -= heuristicWeightStep;
+		if (heuristicWeight < 1 || heuristicWeightStep <= 0)
+			heuristicWeight = 1;
+		++anytimeIteration;
+
+		// The goal stays open so the next pass stops on it again
+		goal->inconsistent = true;
+		inconsistentNodes.push_back(goal);
+		RekeyOpenNodes();
+	}
+
+	void PathSearch::RekeyOpenNodes()
+	{
+		std::vector<PlannerNode*> openNodes;
+		queue.enumerate(openNodes);
+		for (auto itter = inconsistentNodes.begin(); itter != inconsistentNodes.end(); ++itter)
+		{
+			(*itter)->inconsistent = false;
+			openNodes.push_back(*itter);
+		}
+		inconsistentNodes.clear();
+
+		for (auto itter = openNodes.begin(); itter != openNodes.end(); ++itter)
+			(*itter)->nodeCost = (*itter)->givenCost + ((*itter)->heuristicCost * heuristicWeight);
+
+		// Pushing from the most to the least expensive appends each node at the front
+		std::sort(openNodes.begin(), openNodes.end(), CompareNodes());
+		queue.clear();
+		for (auto itter = openNodes.begin(); itter != openNodes.end(); ++itter)
+			queue.push(*itter);
+	}
+
+	bool PathSearch::PruneNodes()
+	{
+		// Open nodes never expanded are leaves of the search tree, safe to delete; the worst
+		// come first.  The best solution so far must stay.
+		std::vector<PlannerNode*> openNodes;
+		queue.enumerate(openNodes);
+
+		// An eighth of the budget at a time keeps the rebuilds of the queue rare, and the
+		// better half of the frontier always stays
+		size_t const batch = (std::min)(static_cast<size_t>(nodeBudget / 8), openNodes.size() / 2);
+		std::vector<PlannerNode*> kept;
+		kept.reserve(openNodes.size());
+		int pruned = 0;
+
+		for (auto itter = openNodes.begin(); itter != openNodes.end(); ++itter)
+		{
+			PlannerNode* node = *itter;
+			if (static_cast<size_t>(pruned) < batch && node->closedIteration == 0
+				&& node != solutionNode)
+			{
+				visited.erase(node->searchNode);
+				delete node;
+				++pruned;
+			}
+			else
+			{
+				kept.push_back(node);
+			}
+		}
+
+		if (pruned == 0)
+			return false;
+
+		// Still sorted, so pushing them back in order rebuilds the queue as it was
+		queue.clear();
+		for (auto itter = kept.begin(); itter != kept.end(); ++itter)
+			queue.push(*itter);
+
+		prunedCount += pruned;
+		return true;
+	}
+
+	HeuristicTable* PathSearch::FindLearnedHeuristic()
+	{
+		if (learnedGoalLimit == 0 || goalNodes.size() != 1 || initialHeuristicWeight > 1
+			|| costOverlay != nullptr || clearanceMap != nullptr)
+			return nullptr;
+
+		int goal = graph.toIndex(goalNodes[0]->tile);
+		auto found = learnedHeuristics.find(goal);
+		if (found == learnedHeuristics.end())
+		{
+			EvictLearnedHeuristics(learnedGoalLimit - 1);
+			found = learnedHeuristics.insert(std::make_pair(goal, LearnedHeuristic())).first;
+			found->second.epoch = learnedEpoch;
+		}
+		else if (found->second.epoch != learnedEpoch)
+		{
+			found->second.table.clear();
+			found->second.epoch = learnedEpoch;
+		}
+
+		found->second.lastUsed = ++learnedUseCount;
+		return &found->second.table;
+	}
+
+	void PathSearch::EvictLearnedHeuristics(int limit)
+	{
+		// Goals are few, so a scan for the oldest beats keeping them in recency order
+		while (static_cast<int>(learnedHeuristics.size()) > limit)
+		{
+			auto oldest = learnedHeuristics.begin();
+			for (auto itter = learnedHeuristics.begin(); itter != learnedHeuristics.end(); ++itter)
+			{
+				if (itter->second.lastUsed < oldest->second.lastUsed)
+					oldest = itter;
+			}
+
+			learnedHeuristics.erase(oldest);
+		}
+	}
+
+	void PathSearch::LearnHeuristic(PlannerNode* goal)
+	{
+		// A cheapest path to the goal costs at most g(n) plus the cost from n onward, so
+		// g(goal) - g(n) never overestimates the latter for a node n expanded at weight 1
+		for (auto itter = visited.begin(); itter != visited.end(); ++itter)
+		{
+			PlannerNode* node = itter->second;
+			if (node->closedIteration != anytimeIteration)
+				continue;
+
+			int learned = goal->givenCost - node->givenCost;
+			if (learned > node->heuristicCost)
+				learnedHeuristic->set(graph.toIndex(node->searchNode->tile),
+					static_cast<unsigned int>(learned));
+		}
+	}
+
+	bool PathSearch::WeightsOnlyRose(std::vector<unsigned char> const& previousWeights,
+		int previousRowCount, int previousColumnCount) const
+	{
+		if (previousRowCount != graph.getRowCount()
+			|| previousColumnCount != graph.getColumnCount()
+			|| static_cast<int>(previousWeights.size()) != graph.getTileCount())
+			return false;
 
-		DrawTiles();
+		// A wall that opened got cheaper; a tile that became a wall got dearer
+		for (int i = 0; i < graph.getTileCount(); ++i)
+		{
+			unsigned char weight = graph.getWeight(i);
+			if (weight != 0 && (previousWeights[i] == 0 || weight < previousWeights[i]))
+				return false;
+		}
+
+		return true;
 	}
 
 	void PathSearch::exit()
 	{
 		bestNode = nullptr;
+		solutionNode = nullptr;
+		inconsistentNodes.clear();
 
 		queue.clear();
 
@@ -188,8 +593,14 @@ namespace fullsail_ai { namespace algorithms {
 	void PathSearch::shutdown()
 	{
 		goalNode = nullptr;
+		goalNodes.clear();
+		goalIndices.clear();
 		bestNode = nullptr;
 		ClearContainers();
+		graph.clear();
+		landmarks.clear();
+		learnedHeuristics.clear();
+		learnedHeuristic = nullptr;
 	}
 
 	bool PathSearch::isDone() const
@@ -197,18 +608,80 @@ namespace fullsail_ai { namespace algorithms {
 		return searchDone;
 	}
 
+	int PathSearch::getReachedGoal() const
+	{
+		if (solutionNode == nullptr)
+			return -1;
+
+		auto found = goalIndices.find(solutionNode->searchNode);
+		return found != goalIndices.end() ? found->second : -1;
+	}
+
+	bool PathSearch::hasSolution() const
+	{
+		return solutionNode != nullptr;
+	}
+
+	double PathSearch::getSuboptimalityBound() const
+	{
+		return solutionNode != nullptr ? suboptimalityBound : 0;
+	}
+
 	std::vector<Tile const*> const PathSearch::getSolution() const
 	{
 		std::vector<Tile const*> temp;
 
-		for (PlannerNode* curr = bestNode; curr != nullptr; curr = curr->parent)
+		// Once an anytime pass reaches the goal, report its path rather than the frontier
+		PlannerNode* last = solutionNode != nullptr ? solutionNode : bestNode;
+		for (PlannerNode* curr = last; curr != nullptr; curr = curr->parent)
 			temp.push_back(curr->searchNode->tile);
 
-		DrawTiles();
+		if (drawing)
+			DrawTiles();
 
 		return temp;
 	}
 
+	int PathSearch::getSolution(Tile const** buffer, int capacity) const
+	{
+		PlannerNode* last = solutionNode != nullptr ? solutionNode : bestNode;
+
+		int length = 0;
+		for (PlannerNode* curr = last; curr != nullptr; curr = curr->parent)
+			++length;
+
+		if (length <= capacity)
+			copySolution(buffer);
+
+		return length;
+	}
+
+	bool PathSearch::getSolution(PathCode& code) const
+	{
+		PlannerNode* last = solutionNode != nullptr ? solutionNode : bestNode;
+		if (last == nullptr)
+		{
+			code.clear();
+			return false;
+		}
+
+		// The parent chain runs goal first, so fill the moves from the back
+		int moves = 0;
+		PlannerNode* first = last;
+		for (; first->parent != nullptr; first = first->parent)
+			++moves;
+
+		code.reset(graph.toIndex(first->searchNode->tile), moves);
+		for (PlannerNode* curr = last; curr->parent != nullptr; curr = curr->parent)
+		{
+			int from = graph.toIndex(curr->parent->searchNode->tile);
+			int to = graph.toIndex(curr->searchNode->tile);
+			code.setDirection(--moves, graph.getDirection(from, to));
+		}
+
+		return true;
+	}
+
 	void const PathSearch::MarkTileAsOpen(Tile* tile, int grade) const
 	{
 		unsigned int openColor = max(255 - (30 * grade), 100);
@@ -237,9 +710,12 @@ namespace fullsail_ai { namespace algorithms {
 		// Draw Visited
 		for (auto itter = visited.begin(); itter != visited.end(); ++itter)
 			MarkTileAsVisited(itter->second->searchNode->tile);
-		// Draw Neighbors
-		for (int i = 0; i < bestNode->searchNode->neighbors.size(); ++i)
-			MarkTileAsNeighbor(bestNode->searchNode->neighbors[i]->tile);
+		// Draw Neighbors; a search whose endpoints were walls never chose one
+		if (bestNode != nullptr)
+		{
+			for (int i = 0; i < bestNode->searchNode->neighbors.size(); ++i)
+				MarkTileAsNeighbor(bestNode->searchNode->neighbors[i]->tile);
+		}
 		// Draw Open
 		std::vector<PlannerNode*> openNodes;
 		queue.enumerate(openNodes);
@@ -323,12 +799,46 @@ namespace fullsail_ai { namespace algorithms {
 
 	double PathSearch::DistanceToGoal(Tile* tile)
 	{
-		double xDistance = goalNode->tile->getRow() - tile->getRow();
-		xDistance *= xDistance;
-		double yDistance = goalNode->tile->getColumn() - tile->getColumn();
-		yDistance *= yDistance;
+		if (static_cast<int>(goalNodes.size()) > MULTI_GOAL_HEURISTIC_LIMIT)
+			return 0;
+
+		double nearest = DistanceBetween(tile, goalNodes[0]->tile);
+		for (size_t i = 1; i < goalNodes.size(); ++i)
+		{
+			double distance = DistanceBetween(tile, goalNodes[i]->tile);
+			if (distance < nearest)
+				nearest = distance;
+		}
+
+		if (learnedHeuristic != nullptr)
+		{
+			double learned = learnedHeuristic->get(graph.toIndex(tile), 0);
+			if (learned > nearest)
+				nearest = learned;
+		}
+
+		return nearest;
+	}
+
+	double PathSearch::DistanceBetween(Tile* tile, Tile* goal)
+	{
+		int tileIndex = graph.toIndex(tile);
+		int goalIndex = graph.toIndex(goal);
+
+		// Every move costs at least the cheapest weight, so this never overestimates
+		unsigned int minimumWeight = costOverlay != nullptr
+			? costOverlay->getMinimumWeight() : graph.getMinimumWeight();
+		unsigned int bound = graph.getHexDistance(tileIndex, goalIndex) * minimumWeight;
+
+		if (heuristic == LANDMARK_HEURISTIC && landmarks.isValidFor(graph)
+			&& (costOverlay == nullptr || !costOverlay->isLoweringWeights()))
+		{
+			unsigned int estimate = landmarks.estimate(graph, tileIndex, goalIndex);
+			if (estimate > bound)
+				bound = estimate;
+		}
 
-		return sqrt(xDistance + yDistance);
+		return bound;
 	}
 
 	double PathSearch::ManhattanDistanceToGoal(Tile* tile)
@@ -35,11 +35,44 @@
 #include "../TileSystem/TileMap.h"
 #include "../platform.h"
 #include "../PriorityQueue.h"
+#include "HexGraph.h"
+#include "Landmarks.h"
+#include "CostOverlay.h"
+#include "ClearanceMap.h"
+#include "PathCode.h"
+#include "HeuristicTable.h"
 
 namespace fullsail_ai { namespace algorithms {
 
 	class PathSearch
 	{
+	public:
+		//! \brief How a search ended, or that it has not.
+		enum Status
+		{
+			//! The search is running, or was never entered.
+			SEARCH_RUNNING,
+			//! The search reached a goal without pruning any node.
+			SEARCH_FOUND,
+			//! The search reached a goal after the node budget made it prune nodes; the path
+			//! may cost more than the cheapest one.
+			SEARCH_DEGRADED,
+			//! No goal can be reached.
+			SEARCH_NO_PATH,
+			//! The search gave up within the node budget: it found no path after pruning, or
+			//! had nothing left to prune.  A goal may still be reachable.
+			SEARCH_FAILED
+		};
+
+		//! \brief Selects how <code>DistanceToGoal()</code> estimates the remaining cost.
+		enum Heuristic
+		{
+			//! Moves between the tiles times the cheapest weight, which never overestimates.
+			HEX_DISTANCE_HEURISTIC,
+			//! Largest landmark triangle bound (ALT); see <code>LandmarkTable</code>.
+			LANDMARK_HEURISTIC
+		};
+
 	private:
 		struct SearchNode
 		{
@@ -56,6 +89,11 @@ namespace fullsail_ai { namespace algorithms {
 			double nodeCost;
 			int givenCost;
 			double heuristicCost;
+
+			// Anytime search bookkeeping: the improvement pass that expanded this node, and
+			// whether it waits in the inconsistent list for the next pass
+			int closedIteration;
+			bool inconsistent;
 		};
 
 		// Search graph
@@ -67,12 +105,16 @@ namespace fullsail_ai { namespace algorithms {
 		
 		//TODO: Add other supporting variables and functions
 		
-		// Node used to check and see if search is complete
+		// Node used to check and see if search is complete; the goal reached once it is
 		SearchNode* goalNode = nullptr;
+		// Every goal of a multi-goal search, and its position in the caller's list
+		std::vector<SearchNode*> goalNodes;
+		std::unordered_map<SearchNode*, int> goalIndices;
 		// Current best path along search
 		PlannerNode* bestNode = nullptr;
 		// Flags when search is finished
 		bool searchDone = false;
+		Status status = SEARCH_RUNNING;
 
 		// Constant offsets used to link neighbors during search graph initialization
 		std::pair<int, int> adjacentTilesEven[6];
@@ -91,6 +133,55 @@ namespace fullsail_ai { namespace algorithms {
 		PriorityQueue<PlannerNode*, CompareNodes> queue;
 		double heuristicWeight = 1;
 
+		// Anytime (ARA*) settings: the search starts at the initial weight and lowers it by
+		// the step after each solution, down to 1
+		double initialHeuristicWeight = 1;
+		double heuristicWeightStep = 0.5;
+		// Improvement pass counter; nodes expanded during the current pass are closed
+		int anytimeIteration = 1;
+		// Closed nodes whose cost dropped during the current pass
+		std::vector<PlannerNode*> inconsistentNodes;
+		// Goal node of the best path found so far, and its bound
+		PlannerNode* solutionNode = nullptr;
+		double suboptimalityBound = 0;
+
+		// Flat copy of the tile map used by the precomputed heuristics
+		HexGraph graph;
+		LandmarkTable landmarks;
+		Heuristic heuristic = HEX_DISTANCE_HEURISTIC;
+		int landmarkCount = 16;
+		// The landmark count the current tables were built or loaded for
+		int builtLandmarkCount = 0;
+		// Unit-class step costs read into the graph in place of the tile weights, if any
+		unsigned char const* costPlane = nullptr;
+		// Per-query costs in place of the tile weights, if any
+		CostOverlay const* costOverlay = nullptr;
+		// Tiles with less room than the unit's radius are skipped, if a map is set
+		ClearanceMap const* clearanceMap = nullptr;
+		int minimumClearance = 0;
+
+		// Adaptive A*: heuristics learned by finished searches, kept per goal tile
+		struct LearnedHeuristic
+		{
+			HeuristicTable table;
+			// Tables from an older epoch are stale, and cleared when next used
+			unsigned int epoch;
+			unsigned int lastUsed;
+		};
+		std::unordered_map<int, LearnedHeuristic> learnedHeuristics;
+		// Table of the current search, or null when it neither uses nor feeds one
+		HeuristicTable* learnedHeuristic = nullptr;
+		int learnedGoalLimit = 0;
+		unsigned int learnedEpoch = 0;
+		unsigned int learnedUseCount = 0;
+
+		// Whether update() and getSolution() color the tiles of the map
+		bool drawing = true;
+
+		// Most planner nodes a search may hold at once, 0 for no limit
+		int nodeBudget = 0;
+		int prunedCount = 0;
+
 		//! \brief draws all tiles
 		void const DrawTiles() const;
 
@@ -112,6 +203,41 @@ namespace fullsail_ai { namespace algorithms {
 		//! \brief Cleans allocated space in all containers.
 		void ClearContainers();
 
+		//! \brief Records the path to the goal found by the current anytime pass, then lowers
+		//! the weight and starts the next pass.
+		//!
+		//! \param   goal  the planner node of the goal, just taken off the queue.
+		void ImproveSolution(PlannerNode* goal);
+
+		//! \brief Moves the inconsistent nodes back into the queue and re-sorts every open
+		//! node by the current weight.
+		void RekeyOpenNodes();
+
+		//! \brief Returns the learned heuristic table for the goal of a search being entered,
+		//! making room for it if needed, or null if the search settings rule learning out.
+		HeuristicTable* FindLearnedHeuristic();
+
+		//! \brief Forgets the goals searched least recently until at most the limit remain.
+		void EvictLearnedHeuristics(int limit);
+
+		//! \brief Raises the learned heuristic of every expanded node from the cost of the
+		//! path just found.
+		//!
+		//! \param   goal  the planner node of the goal, reached at weight 1.
+		void LearnHeuristic(PlannerNode* goal);
+
+		//! \brief Frees the open nodes with the highest costs that were never expanded.
+		//!
+		//! Expanded nodes stay, so the search still never expands a tile twice and always
+		//! ends.  A pruned tile is generated again if another expansion reaches it.
+		//!
+		//! \return  false if no node could be pruned.
+		bool PruneNodes();
+
+		//! \brief Returns true if no tile got cheaper or opened since the previous snapshot.
+		bool WeightsOnlyRose(std::vector<unsigned char> const& previousWeights,
+			int previousRowCount, int previousColumnCount) const;
+
 		//! \brief Cleans allocated space in queue.
 		//void ClearQueue();
 
@@ -128,8 +254,14 @@ namespace fullsail_ai { namespace algorithms {
 		SearchNode* GetSearchNode(Tile* tile);
 
 		//! \brief Distance calculation of tile to goal for heuristics
+		//!
+		//! With several goals this is the lowest estimate to any of them, or zero (plain
+		//! Dijkstra) once there are more than <code>MULTI_GOAL_HEURISTIC_LIMIT</code>.
 		double DistanceToGoal(Tile* tile);
 
+		//! \brief Estimated cost between a tile and one goal tile
+		double DistanceBetween(Tile* tile, Tile* goal);
+
 		double ManhattanDistanceToGoal(Tile* tile);
 
 		// DEBUG FUNCTIONS
@@ -151,6 +283,147 @@ namespace fullsail_ai { namespace algorithms {
 		//!                    to access each tile's location and weight data.
 		DLLEXPORT void initialize(TileMap* _tileMap);
 
+		//! \brief Sets the tile map, reusing landmark tables saved next to it.
+		//!
+		//! Behaves like <code>initialize(TileMap*)</code>, except that when the landmark
+		//! heuristic is selected the tables are first read from <code>landmarkFileName</code>.
+		//! If the file is missing, was built for a different map or holds a different number
+		//! of landmarks, the tables are rebuilt and written back to it.
+		//!
+		//! \param   _tileMap          the tile map to search.
+		//! \param   landmarkFileName  where the landmark tables are kept, usually the map file
+		//!                           name followed by <code>.alt</code>.
+		DLLEXPORT void initialize(TileMap* _tileMap, char const* landmarkFileName);
+
+		//! \brief Selects the heuristic used by subsequent searches.
+		//!
+		//! Takes effect at the next <code>initialize()</code>, which is when the landmark
+		//! tables are built.  Tables for the same map are kept unless the landmark count
+		//! changed.
+		//!
+		//! \param   _heuristic      the heuristic to use.
+		//! \param   _landmarkCount  the number of landmarks for <code>LANDMARK_HEURISTIC</code>.
+		DLLEXPORT void setHeuristic(Heuristic _heuristic, int _landmarkCount = 16);
+
+		//! \brief Writes the current landmark tables to a file.
+		//!
+		//! \return  true if tables exist and were written.
+		DLLEXPORT bool saveLandmarks(char const* fileName) const;
+
+		//! \brief Replaces the landmark tables with those saved in a file.
+		//!
+		//! \return  true if the file matches the current tile map.
+		DLLEXPORT bool loadLandmarks(char const* fileName);
+
+		//! \brief Makes searches pay a unit class's step costs instead of the tile weights.
+		//!
+		//! Takes effect at the next <code>initialize()</code>, which reads the costs into the
+		//! snapshot the heuristics and learned tables also use, so expansions pay nothing
+		//! extra.  Tiles the plane marks zero are impassable.
+		//!
+		//! \param   plane  one cost per tile of the map passed to <code>initialize()</code>, as
+		//!                 filled by <code>computeCostPlane()</code>, or <code>nullptr</code>
+		//!                 for the tile weights; read only during <code>initialize()</code>.
+		DLLEXPORT void setCostPlane(unsigned char const* plane);
+
+		//! \brief Replaces the tile weights with an overlay's costs for subsequent searches.
+		//!
+		//! The tile map is not modified.  The landmark heuristic is set aside while the
+		//! overlay makes any terrain cheaper, since its tables would then overestimate.
+		//!
+		//! \param   overlay  the costs to use, or <code>nullptr</code> for the tile weights;
+		//!                  must outlive the searches that use it.
+		DLLEXPORT void setCostOverlay(CostOverlay const* overlay);
+
+		//! \brief Keeps subsequent searches to tiles with at least the specified clearance.
+		//!
+		//! Successors whose clearance is below the minimum are never opened, so a unit of that
+		//! radius is routed around gaps it does not fit through.  The start tile is exempt; a
+		//! goal with less room cannot be reached.
+		//!
+		//! \param   clearance  the clearance of the current tile map, or <code>nullptr</code>
+		//!                     to search every passable tile; must outlive the searches.
+		//! \param   minimum    the radius of the unit, zero for a single tile.
+		DLLEXPORT void setMinimumClearance(ClearanceMap const* clearance, int minimum);
+
+		//! \brief Selects anytime repairing A* (ARA*) for subsequent searches.
+		//!
+		//! The search first inflates the heuristic by <code>_initialWeight</code>, so it
+		//! reaches the goal quickly with a path at most that many times the optimal cost.  It
+		//! then lowers the weight by <code>_weightStep</code> and keeps improving the path,
+		//! reopening only the nodes whose cost dropped since they were expanded, until the
+		//! weight reaches 1 and the path is optimal.  <code>isDone()</code> only returns true
+		//! then; in between, <code>hasSolution()</code> tells whether a path is available.
+		//!
+		//! The bound holds because both heuristics are admissible and consistent.
+		//!
+		//! \param   _initialWeight  the first heuristic weight; 1 or less disables anytime
+		//!                         mode.
+		//! \param   _weightStep      how much to lower the weight after each solution.
+		DLLEXPORT void setAnytime(double _initialWeight, double _weightStep = 0.5);
+
+		//! \brief Selects Adaptive A* for subsequent searches, so that repeated queries to a
+		//! goal expand fewer nodes.
+		//!
+		//! Once a search reaches its goal, every node it expanded learns the cost of the path
+		//! minus its own cost from the start.  That never overestimates the remaining cost,
+		//! and later searches to the same goal use it wherever it beats the heuristic.  The
+		//! learned values are exact bounds, and keep the heuristic consistent, since both
+		//! heuristics are consistent.
+		//!
+		//! Higher weights keep learned values admissible and consistent, so a reloaded map
+		//! on which no tile got cheaper or opened keeps them; any other change makes
+		//! <code>initialize()</code> drop them.  Searches with several goals, anytime weights,
+		//! a cost overlay or a minimum clearance neither use nor feed them.
+		//!
+		//! \param   goalLimit  the most goals to keep learned values for, dropping the goal
+		//!                     searched least recently first; 0 disables Adaptive A* and
+		//!                     forgets everything learned.
+		DLLEXPORT void setAdaptive(int goalLimit);
+
+		//! \brief Forgets every learned heuristic.
+		//!
+		//! <code>initialize()</code> does so by itself when needed; call this only if the
+		//! costs searched with got lower by some other means.
+		DLLEXPORT void invalidateLearnedHeuristics();
+
+		//! \brief Returns the bytes held by the learned heuristics of every goal.
+		DLLEXPORT size_t getLearnedMemoryUsage() const;
+
+		//! \brief Caps the planner nodes of subsequent searches.
+		//!
+		//! A search about to exceed the budget drops its most expensive open nodes, much as
+		//! a beam search keeps only the best of its frontier.  It then reports
+		//! <code>SEARCH_DEGRADED</code> if it still reaches a goal, and
+		//! <code>SEARCH_FAILED</code> if it runs out of open nodes, or if its expanded nodes
+		//! alone fill the budget.  Adaptive A* learns nothing from a search that pruned.
+		//!
+		//! \param   budget  the most planner nodes a search may hold at once, at least 64;
+		//!                  0 lifts the cap.
+		DLLEXPORT void setNodeBudget(int budget);
+
+		//! \brief Turns the coloring of visited, open and path tiles on or off.
+		//!
+		//! Drawing resets every tile of the map, then repaints those the search touched, after
+		//! each <code>update()</code> and <code>getSolution()</code>; that can cost more than the
+		//! search itself.  Turn it off when nothing displays the map, as in benchmarks.
+		//!
+		//! \param   enabled  true to draw, as by default.
+		DLLEXPORT void setDrawing(bool enabled);
+
+		//! \brief Returns how the current search ended, or that it is still running.
+		DLLEXPORT Status getStatus() const;
+
+		//! \brief Returns the number of planner nodes the current search holds.
+		DLLEXPORT int getNodeCount() const;
+
+		//! \brief Returns the number of planner nodes the current search has pruned.
+		DLLEXPORT int getPrunedCount() const;
+
+		//! Above this many goals the heuristic is dropped, as evaluating it would cost more
+		//! than the expansions it saves.
+		static const int MULTI_GOAL_HEURISTIC_LIMIT = 16;
+
 		//! \brief Enters and performs the first part of the algorithm.
 		//!
 		//! Invoked when the user presses one of the play buttons.
@@ -161,9 +434,28 @@ namespace fullsail_ai { namespace algorithms {
 		//! \param   goalColumn       the column where the goal tile is located.
 		DLLEXPORT void enter(int startRow, int startColumn, int goalRow, int goalColumn);
 
-		//! \brief Returns true if and only if no nodes are left open.
+		//! \brief Enters a search for the cheapest path to any of several goal tiles.
 		//!
-		//! \return true if no nodes are left open, false otherwise.
+		//! One search serves every goal: it stops at the first goal taken off the open list,
+		//! which is the nearest one when the heuristic is admissible.  Impassable goals are
+		//! ignored.
+		//!
+		//! \param   startRow     the row where the start tile is located.
+		//! \param   startColumn  the column where the start tile is located.
+		//! \param   goals        the (row, column) of every goal tile.
+		DLLEXPORT void enter(int startRow, int startColumn,
+			std::vector<std::pair<int, int> > const& goals);
+
+		//! \brief Returns the position in the list given to <code>enter()</code> of the goal
+		//! the solution leads to, or -1 if no goal has been reached.
+		DLLEXPORT int getReachedGoal() const;
+
+		//! \brief Returns true once the search has ended, whether or not it reached a goal.
+		//!
+		//! <code>getStatus()</code> tells how it ended.  An anytime search ends only once its
+		//! path is optimal.
+		//!
+		//! \return true if the search has ended, false if <code>update()</code> has work left.
 		DLLEXPORT bool isDone() const;
 
 		//! \brief Performs the main part of the algorithm until the specified time has elapsed or
@@ -171,11 +463,66 @@ namespace fullsail_ai { namespace algorithms {
 		DLLEXPORT void update(long timeslice);
 
 		//! \brief Returns an unmodifiable view of the solution path found by this algorithm.
+		//!
+		//! In anytime mode this is the best path found so far, once <code>hasSolution()</code>
+		//! returns true.
 		DLLEXPORT std::vector<Tile const*> const getSolution() const;
 
+		//! \brief Writes the solution path, goal first, to a caller's buffer.
+		//!
+		//! Unlike <code>getSolution()</code> this allocates nothing and leaves the tile
+		//! colors alone.
+		//!
+		//! \param   buffer    the buffer.
+		//! \param   capacity  the number of tiles the buffer holds.
+		//! \return  the number of tiles on the path; nothing is written if that exceeds the
+		//!          capacity.
+		DLLEXPORT int getSolution(Tile const** buffer, int capacity) const;
+
+		//! \brief Encodes the path that <code>getSolution()</code> would return compactly,
+		//! start first.
+		//!
+		//! \return  false, leaving the code empty, if no search has run.
+		DLLEXPORT bool getSolution(PathCode& code) const;
+
+		//! \brief Writes the solution path, goal first, to an output iterator, without
+		//! allocating or touching the tile colors.
+		//!
+		//! \return  the iterator past the last tile written.
+		template <class OutputIterator>
+		OutputIterator copySolution(OutputIterator out) const
+		{
+			PlannerNode* last = solutionNode != nullptr ? solutionNode : bestNode;
+			for (PlannerNode* curr = last; curr != nullptr; curr = curr->parent)
+			{
+				*out = static_cast<Tile const*>(curr->searchNode->tile);
+				++out;
+			}
+
+			return out;
+		}
+
+		//! \brief Returns true if a path to the goal is available from
+		//! <code>getSolution()</code>, even if the search goes on improving it.
+		DLLEXPORT bool hasSolution() const;
+
+		//! \brief Returns how many times the optimal cost the current solution may cost at
+		//! most, or 0 if there is no solution yet.  A plain search reports the heuristic
+		//! weight; an anytime search tightens it with the open nodes' lowest unweighted cost.
+		DLLEXPORT double getSuboptimalityBound() const;
+
 		//! \brief Resets the algorithm.
 		DLLEXPORT void exit();
 
+		//! \brief Returns the flat graph built by the last <code>initialize()</code>.
+		//!
+		//! Share it with preprocessed searches such as <code>ContractionHierarchy</code>
+		//! instead of building another snapshot of the same map.
+		inline HexGraph const& getGraph() const
+		{
+			return graph;
+		}
+
 		//! \brief Uninitializes the algorithm before the tile map is unloaded.
 		DLLEXPORT void shutdown();
 	};
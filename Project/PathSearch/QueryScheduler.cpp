@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "QueryScheduler.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	const int QueryScheduler::PRIORITY_COUNT;
+	const int QueryScheduler::LATENCY_BUCKET_COUNT;
+
+	double QueryScheduler::LatencyStats::getMean() const
+	{
+		unsigned int count = completedCount + degradedCount;
+		return count != 0 ? totalMicroseconds / count : 0;
+	}
+
+	double QueryScheduler::LatencyStats::getPercentile(double fraction) const
+	{
+		unsigned int count = completedCount + degradedCount;
+		if (count == 0)
+			return 0;
+
+		double rank = fraction * count;
+		unsigned int seen = 0;
+		for (int b = 0; b < LATENCY_BUCKET_COUNT; ++b)
+		{
+			seen += histogram[b];
+			if (seen != 0 && seen >= rank)
+			{
+				double bound = static_cast<double>(1u << b);
+				return bound < maxMicroseconds ? bound : maxMicroseconds;
+			}
+		}
+
+		return maxMicroseconds;
+	}
+
+	QueryScheduler::QueryScheduler(unsigned int _sliceBudget, unsigned int _starvationFrames)
+		: frame(0), sliceBudget(_sliceBudget != 0 ? _sliceBudget : 1),
+		starvationFrames(_starvationFrames)
+	{
+		resetStats();
+	}
+
+	void QueryScheduler::resetStats()
+	{
+		std::memset(stats, 0, sizeof(stats));
+	}
+
+	int QueryScheduler::submit(SearchSession&& session, Clock::time_point deadline,
+		int priority)
+	{
+		int id;
+		if (freeIds.empty())
+		{
+			id = static_cast<int>(queries.size());
+			queries.push_back(Query());
+		}
+		else
+		{
+			id = freeIds.back();
+			freeIds.pop_back();
+		}
+
+		Query& query = queries[id];
+		query.session = std::move(session);
+		query.submitted = Clock::now();
+		query.deadline = deadline;
+		query.priority = priority < 0 ? 0
+			: priority >= PRIORITY_COUNT ? PRIORITY_COUNT - 1 : priority;
+		query.status = QUERY_RUNNING;
+		query.lastServedFrame = frame;
+
+		if (query.session.isDone())
+			Retire(id, QUERY_COMPLETED, query.submitted);
+		else
+			running.push_back(id);
+		return id;
+	}
+
+	void QueryScheduler::remove(int id)
+	{
+		if (getStatus(id) == QUERY_UNKNOWN)
+			return;
+
+		running.erase(std::remove(running.begin(), running.end(), id), running.end());
+		queries[id].session = SearchSession();
+		queries[id].status = QUERY_UNKNOWN;
+		freeIds.push_back(id);
+	}
+
+	QueryScheduler::Status QueryScheduler::getStatus(int id) const
+	{
+		if (id < 0 || id >= static_cast<int>(queries.size()))
+			return QUERY_UNKNOWN;
+		return queries[id].status;
+	}
+
+	void QueryScheduler::Retire(int id, Status status, Clock::time_point now)
+	{
+		Query& query = queries[id];
+		query.status = status;
+
+		double latency =
+			std::chrono::duration<double, std::micro>(now - query.submitted).count();
+		int bucket = 0;
+		while (bucket + 1 < LATENCY_BUCKET_COUNT && latency >= static_cast<double>(1u << bucket))
+			++bucket;
+
+		LatencyStats& stat = stats[query.priority];
+		if (status == QUERY_DEGRADED)
+			++stat.degradedCount;
+		else
+			++stat.completedCount;
+		stat.totalMicroseconds += latency;
+		if (latency > stat.maxMicroseconds)
+			stat.maxMicroseconds = latency;
+		++stat.histogram[bucket];
+	}
+
+	unsigned int QueryScheduler::Serve(int id, unsigned int budget, Clock::time_point now)
+	{
+		Query& query = queries[id];
+		if (query.status != QUERY_RUNNING)
+			return 0;
+
+		if (now >= query.deadline)
+		{
+			// The last step may still reach the goal or empty the open list
+			query.session.finish();
+			Retire(id, query.session.isPartial() ? QUERY_DEGRADED : QUERY_COMPLETED, now);
+			return 0;
+		}
+
+		unsigned int before = query.session.getExpansionCount();
+		bool done = query.session.resume(budget);
+		query.lastServedFrame = frame;
+		if (done)
+			Retire(id, QUERY_COMPLETED, Clock::now());
+
+		// A slice that finds the goal at once still counts, so callers always advance
+		unsigned int expanded = query.session.getExpansionCount() - before;
+		return expanded != 0 ? expanded : 1;
+	}
+
+	unsigned int QueryScheduler::runFrame(unsigned int expansionBudget,
+		Clock::duration timeBudget)
+	{
+		Clock::time_point now = Clock::now();
+		Clock::time_point frameEnd = now + timeBudget;
+		bool timed = timeBudget > Clock::duration::zero();
+		++frame;
+
+		// Earliest deadline first, then highest priority
+		std::vector<int> order(running);
+		std::vector<Query> const& all = queries;
+		std::sort(order.begin(), order.end(), [&](int a, int b)
+		{
+			if (all[a].deadline != all[b].deadline)
+				return all[a].deadline < all[b].deadline;
+			return all[a].priority > all[b].priority;
+		});
+
+		unsigned int spent = 0;
+
+		// Overdue queries are finished whatever the budget
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			if (now >= queries[order[i]].deadline)
+				Serve(order[i], 0, now);
+		}
+
+		// One slice for each query that has waited too long
+		for (size_t i = 0; i < order.size() && spent < expansionBudget; ++i)
+		{
+			if (timed && now >= frameEnd)
+				break;
+			if (frame - queries[order[i]].lastServedFrame <= starvationFrames)
+				continue;
+
+			unsigned int slice = expansionBudget - spent < sliceBudget
+				? expansionBudget - spent : sliceBudget;
+			spent += Serve(order[i], slice, now);
+			now = Clock::now();
+		}
+
+		// The rest earliest deadline first, each until it finishes
+		for (size_t i = 0; i < order.size() && spent < expansionBudget; ++i)
+		{
+			if (timed && now >= frameEnd)
+				break;
+
+			while (queries[order[i]].status == QUERY_RUNNING && spent < expansionBudget)
+			{
+				unsigned int slice = expansionBudget - spent < sliceBudget
+					? expansionBudget - spent : sliceBudget;
+				spent += Serve(order[i], slice, now);
+				now = Clock::now();
+				if (timed && now >= frameEnd)
+					break;
+			}
+		}
+
+		std::vector<int> stillRunning;
+		for (size_t i = 0; i < running.size(); ++i)
+		{
+			if (queries[running[i]].status == QUERY_RUNNING)
+				stillRunning.push_back(running[i]);
+		}
+		running.swap(stillRunning);
+
+		return spent;
+	}
+}}  // namespace fullsail_ai::algorithms
@@ -0,0 +1,147 @@
+//! \file QueryScheduler.h
+//! \brief Defines the fullsail_ai::algorithms::QueryScheduler class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_QUERY_SCHEDULER_H_
+#define _FULLSAIL_AI_PATH_PLANNER_QUERY_SCHEDULER_H_
+
+#include <chrono>
+#include <vector>
+#include "SearchSession.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Runs many path queries with deadlines, a frame at a time.
+	//!
+	//! Each frame hands out a budget of expansions, and optionally of time, earliest
+	//! deadline first: the most urgent query runs in slices until it finishes, then the next.
+	//! A query that has not run for a number of frames is served one slice before the others,
+	//! so later deadlines still make progress under load.  A query still running when its
+	//! deadline passes is finished with the best partial path found so far and counted as
+	//! degraded, unless that last step completes the search.
+	//!
+	//! Latency, from submission to completion, is recorded per priority.
+	class QueryScheduler
+	{
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		static const int PRIORITY_COUNT = 4;
+		static const int LATENCY_BUCKET_COUNT = 32;
+
+		enum Status
+		{
+			//! The query is waiting for or receiving budget.
+			QUERY_RUNNING,
+			//! The search finished at the goal or with no path.
+			QUERY_COMPLETED,
+			//! The deadline passed; the session holds a partial path.
+			QUERY_DEGRADED,
+			//! The id does not name a query.
+			QUERY_UNKNOWN
+		};
+
+		//! \brief Latency of the queries of one priority.
+		struct LatencyStats
+		{
+			unsigned int completedCount;
+			unsigned int degradedCount;
+			double totalMicroseconds;
+			double maxMicroseconds;
+			//! Bucket <code>b</code> counts latencies below <code>2^b</code> microseconds
+			//! and at or above half that.
+			unsigned int histogram[LATENCY_BUCKET_COUNT];
+
+			//! \brief Returns the mean latency in microseconds.
+			DLLEXPORT double getMean() const;
+
+			//! \brief Returns an upper bound on the specified latency percentile, in
+			//! microseconds, rounded up to a power of two or down to the maximum.
+			//!
+			//! \param   fraction  the percentile as a fraction, such as 0.95.
+			DLLEXPORT double getPercentile(double fraction) const;
+		};
+
+	private:
+		struct Query
+		{
+			SearchSession session;
+			Clock::time_point submitted;
+			Clock::time_point deadline;
+			int priority;
+			Status status;
+			unsigned int lastServedFrame;
+		};
+
+		std::vector<Query> queries;
+		std::vector<int> freeIds;
+		// Ids of queries still running
+		std::vector<int> running;
+		LatencyStats stats[PRIORITY_COUNT];
+		unsigned int frame;
+		unsigned int sliceBudget;
+		unsigned int starvationFrames;
+
+		void Retire(int id, Status status, Clock::time_point now);
+
+		// Runs one slice of a query; returns the expansions spent
+		unsigned int Serve(int id, unsigned int budget, Clock::time_point now);
+
+	public:
+		//! \brief Constructor.
+		//!
+		//! \param   _sliceBudget       the expansions a query runs between checks of the
+		//!                             clock and of its deadline.
+		//! \param   _starvationFrames  frames a query may wait before it is served ahead of
+		//!                             earlier deadlines.
+		DLLEXPORT QueryScheduler(unsigned int _sliceBudget = 64,
+			unsigned int _starvationFrames = 8);
+
+		//! \brief Takes ownership of a search session.
+		//!
+		//! \param   session   the query to run.
+		//! \param   deadline  when the query must be answered.
+		//! \param   priority  from 0 to <code>PRIORITY_COUNT - 1</code>; higher priorities
+		//!                    go first among equal deadlines and are reported separately.
+		//! \return  the id used to read and remove the query.
+		DLLEXPORT int submit(SearchSession&& session, Clock::time_point deadline,
+			int priority = 0);
+
+		//! \brief Destroys a query, finished or not, and frees its id.
+		DLLEXPORT void remove(int id);
+
+		//! \brief Returns the state of a query.
+		DLLEXPORT Status getStatus(int id) const;
+
+		//! \brief Returns the session of a query, to read its path once it is not running.
+		inline SearchSession const& get(int id) const
+		{
+			return queries[id].session;
+		}
+
+		//! \brief Returns the number of queries still running.
+		inline size_t getRunningCount() const
+		{
+			return running.size();
+		}
+
+		//! \brief Spends one frame's budget on the running queries.
+		//!
+		//! \param   expansionBudget  the most expansions to spend.
+		//! \param   timeBudget       the most time to spend, checked between slices; zero
+		//!                           means no limit.
+		//! \return  the number of expansions spent.
+		DLLEXPORT unsigned int runFrame(unsigned int expansionBudget,
+			Clock::duration timeBudget = Clock::duration::zero());
+
+		//! \brief Returns the latency of the queries of one priority retired so far.
+		inline LatencyStats const& getStats(int priority) const
+		{
+			return stats[priority];
+		}
+
+		//! \brief Forgets all recorded latencies.
+		DLLEXPORT void resetStats();
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_QUERY_SCHEDULER_H_
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <functional>
+#include "RangeQuery.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		// Every step on base weights costs at most 255, so 256 buckets never wrap onto a
+		// pending cost; dearer steps go to the overflow heap
+		unsigned int const BUCKET_COUNT = 256;
+	}
+
+	RangeQuery::RangeQuery()
+		: buckets(BUCKET_COUNT), source(-1)
+	{
+	}
+
+	void RangeQuery::run(HexGraph const& graph, int _source, unsigned int budget,
+		CostOverlay const* overlay)
+	{
+		int const tiles = graph.getTileCount();
+		if (static_cast<int>(costs.size()) != tiles)
+		{
+			costs.assign(tiles, HexGraph::INFINITE_COST);
+			parents.assign(tiles, -1);
+			labelled.assign((tiles + 31) >> 5, 0);
+			reached.clear();
+		}
+
+		// Forget only what the previous query touched
+		for (auto itter = reached.begin(); itter != reached.end(); ++itter)
+			labelled[*itter >> 5] &= ~(1u << (*itter & 31));
+		reached.clear();
+
+		source = _source;
+		if (!graph.isPassable(source))
+			return;
+
+		std::greater<std::pair<unsigned int, int> > const later;
+		overflow.clear();
+
+		costs[source] = 0;
+		parents[source] = -1;
+		labelled[source >> 5] |= 1u << (source & 31);
+		buckets[0].push_back(source);
+		// Entries in the buckets, not counting the overflow heap
+		int pending = 1;
+
+		for (unsigned int current = 0; pending > 0 || !overflow.empty(); ++current)
+		{
+			// With the buckets empty, skip straight to the cheapest dear step
+			if (pending == 0)
+				current = overflow.front().first;
+
+			while (!overflow.empty() && overflow.front().first == current)
+			{
+				buckets[current % BUCKET_COUNT].push_back(overflow.front().second);
+				std::pop_heap(overflow.begin(), overflow.end(), later);
+				overflow.pop_back();
+				++pending;
+			}
+
+			std::vector<int>& bucket = buckets[current % BUCKET_COUNT];
+
+			while (!bucket.empty())
+			{
+				int tile = bucket.back();
+				bucket.pop_back();
+				--pending;
+
+				// Skip stale entries left behind by cheaper pushes
+				if (costs[tile] != current)
+					continue;
+
+				reached.push_back(tile);
+
+				for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+				{
+					int neighbor = graph.getNeighbor(tile, d);
+					if (neighbor < 0)
+						continue;
+
+					unsigned int step = overlay != 0
+						? overlay->getCost(graph, neighbor) : graph.getWeight(neighbor);
+					if (step == HexGraph::INFINITE_COST || step > budget - current)
+						continue;
+
+					unsigned int cost = current + step;
+
+					if (!IsLabelled(neighbor))
+						labelled[neighbor >> 5] |= 1u << (neighbor & 31);
+					else if (cost >= costs[neighbor])
+						continue;
+
+					costs[neighbor] = cost;
+					parents[neighbor] = tile;
+					if (step < BUCKET_COUNT)
+					{
+						buckets[cost % BUCKET_COUNT].push_back(neighbor);
+						++pending;
+					}
+					else
+					{
+						overflow.push_back(std::make_pair(cost, neighbor));
+						std::push_heap(overflow.begin(), overflow.end(), later);
+					}
+				}
+			}
+		}
+	}
+
+	unsigned int RangeQuery::extractPath(HexGraph const& graph, int target,
+		std::vector<Tile const*>& path) const
+	{
+		path.clear();
+		if (!isReached(target))
+			return HexGraph::INFINITE_COST;
+
+		for (int tile = target; tile >= 0; tile = parents[tile])
+			path.push_back(graph.getTile(tile));
+
+		return costs[target];
+	}
+}}  // namespace fullsail_ai::algorithms
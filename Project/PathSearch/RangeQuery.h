@@ -0,0 +1,101 @@
+//! \file RangeQuery.h
+//! \brief Defines the fullsail_ai::algorithms::RangeQuery class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_RANGE_QUERY_H_
+#define _FULLSAIL_AI_PATH_PLANNER_RANGE_QUERY_H_
+
+#include <utility>
+#include <vector>
+#include "HexGraph.h"
+#include "CostOverlay.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Every tile reachable from a source within a cost budget, such as a unit's
+	//! movement range for one turn.
+	//!
+	//! A Dijkstra search bounded by the budget, on a bucket queue over the step costs, with
+	//! a small heap for the rare steps an overlay penalty makes dearer than a byte.  The
+	//! per-tile arrays, the buckets and the heap are kept between queries, and only the tiles
+	//! reached by the previous query are cleared, so once warmed up a query allocates nothing
+	//! and costs time in proportion to the tiles it reaches rather than to the map.
+	class RangeQuery
+	{
+		std::vector<unsigned int> costs;
+		std::vector<int> parents;
+		// One bit per tile: set if the tile has a cost from the current query
+		std::vector<unsigned int> labelled;
+		std::vector<std::vector<int> > buckets;
+		// Steps dearer than the buckets span, by cost, for overlay penalties
+		std::vector<std::pair<unsigned int, int> > overflow;
+		// Reached tiles, cheapest first
+		std::vector<int> reached;
+		int source;
+
+		inline bool IsLabelled(int tile) const
+		{
+			return (labelled[tile >> 5] >> (tile & 31)) & 1;
+		}
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT RangeQuery();
+
+		//! \brief Finds every tile whose cheapest path from the source costs at most the
+		//! budget.
+		//!
+		//! \param   graph    the graph to search.
+		//! \param   _source  index of the tile to start from.
+		//! \param   budget   the most a path may cost.
+		//! \param   overlay  optional costs for this query in place of the tile weights.
+		DLLEXPORT void run(HexGraph const& graph, int _source, unsigned int budget,
+			CostOverlay const* overlay = 0);
+
+		//! \brief Returns the source of the last query, or -1 before the first.
+		inline int getSource() const
+		{
+			return source;
+		}
+
+		//! \brief Returns the indices of the reached tiles, cheapest first, starting with the
+		//! source.
+		inline std::vector<int> const& getReached() const
+		{
+			return reached;
+		}
+
+		//! \brief Returns true if the last query reached the tile.
+		inline bool isReached(int tile) const
+		{
+			return tile >= 0 && (tile >> 5) < static_cast<int>(labelled.size())
+				&& IsLabelled(tile);
+		}
+
+		//! \brief Returns the cost from the source to a tile, or
+		//! <code>HexGraph::INFINITE_COST</code> if it is out of range.
+		inline unsigned int getCost(int tile) const
+		{
+			return isReached(tile) ? costs[tile] : HexGraph::INFINITE_COST;
+		}
+
+		//! \brief Returns the tile before this one on its cheapest path from the source, or -1
+		//! for the source and tiles out of range.
+		inline int getParent(int tile) const
+		{
+			return isReached(tile) ? parents[tile] : -1;
+		}
+
+		//! \brief Builds the path from the source to a reached tile.
+		//!
+		//! \param   graph   the graph of the last query.
+		//! \param   target  index of the tile to reach.
+		//! \param   path    receives the tiles ordered like
+		//!                  <code>PathSearch::getSolution()</code>: target first, source
+		//!                  last.  Left empty if the target is out of range.
+		//! \return  the cost of the path, or <code>HexGraph::INFINITE_COST</code>.
+		DLLEXPORT unsigned int extractPath(HexGraph const& graph, int target,
+			std::vector<Tile const*>& path) const;
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_RANGE_QUERY_H_
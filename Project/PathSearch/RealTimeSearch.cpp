@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <functional>
+#include "RealTimeSearch.h"
+#include "BitFloodFill.h"
+#include "HexBitboard.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		// Orders the open list by estimated total cost, then by the larger cost so far
+		inline unsigned long long MakeKey(unsigned int given, unsigned int estimate)
+		{
+			return (static_cast<unsigned long long>(given + estimate) << 32)
+				| (0xFFFFFFFFu - given);
+		}
+	}
+
+	RealTimeSearch::RealTimeSearch()
+		: graph(0), landmarks(0), lookahead(32), expandedCount(0)
+	{
+	}
+
+	void RealTimeSearch::initialize(HexGraph const& _graph, LandmarkTable const* _landmarks)
+	{
+		graph = &_graph;
+		landmarks = _landmarks && _landmarks->isValidFor(_graph) ? _landmarks : 0;
+		tables.clear();
+		expandedCount = 0;
+		setLookahead(lookahead);
+
+		HexBitboard passable;
+		passable.build(_graph);
+		BitFloodFill().labelComponents(passable, regions);
+	}
+
+	void RealTimeSearch::setLookahead(int _lookahead)
+	{
+		lookahead = _lookahead > 0 ? _lookahead : 1;
+
+		// Every expansion opens at most six tiles, so the lookahead never allocates
+		size_t const reached = static_cast<size_t>(lookahead) * HexGraph::DIRECTION_COUNT + 1;
+		open.reserve(reached);
+		frontier.reserve(reached * 2);
+		closed.reserve(lookahead);
+
+		// The label table starts growing a quarter full
+		int bits = 6;
+		while ((static_cast<size_t>(1) << bits) < reached * 4)
+			++bits;
+		labels = StampedHashTable<int, Label>(bits);
+	}
+
+	unsigned int RealTimeSearch::InitialEstimate(int tile, int goal) const
+	{
+		unsigned int estimate =
+			static_cast<unsigned int>(graph->getHexDistance(tile, goal)) * graph->getMinimumWeight();
+
+		if (landmarks)
+			estimate = (std::max)(estimate, landmarks->estimate(*graph, tile, goal));
+
+		return estimate;
+	}
+
+	int RealTimeSearch::step(int current, int goal)
+	{
+		expandedCount = 0;
+
+		if (current == goal)
+			return goal;
+		// Walls have no region, and tiles in different regions never meet
+		if (regions[current] < 0 || regions[current] != regions[goal])
+			return -1;
+
+		HeuristicTable& table = tables[goal];
+		if (Estimate(table, current, goal) == HexGraph::INFINITE_COST)
+			return -1;
+
+		labels.clear();
+		open.clear();
+		closed.clear();
+
+		bool added;
+		Label& start = labels.insert(current, added);
+		start.given = 0;
+		start.value = Estimate(table, current, goal);
+		start.parent = -1;
+		start.closed = false;
+		open.push_back(std::make_pair(MakeKey(0, start.value), current));
+
+		std::greater<std::pair<unsigned long long, int> > const later;
+		int best = -1;
+
+		while (!open.empty())
+		{
+			std::pop_heap(open.begin(), open.end(), later);
+			std::pair<unsigned long long, int> top = open.back();
+			open.pop_back();
+
+			int tile = top.second;
+			Label& label = *labels.find(tile);
+			if (label.closed || top.first != MakeKey(label.given, label.value))
+				continue;
+
+			// The most promising frontier tile, left open for learning
+			if (tile == goal || expandedCount == lookahead)
+			{
+				best = tile;
+				open.push_back(top);
+				std::push_heap(open.begin(), open.end(), later);
+				break;
+			}
+
+			label.closed = true;
+			closed.push_back(tile);
+			++expandedCount;
+
+			for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+			{
+				int neighbor = graph->getNeighbor(tile, d);
+				if (neighbor < 0)
+					continue;
+
+				Label& next = labels.insert(neighbor, added);
+				if (added)
+				{
+					next.given = HexGraph::INFINITE_COST;
+					next.value = Estimate(table, neighbor, goal);
+					next.parent = -1;
+					next.closed = false;
+				}
+
+				// Tiles known not to reach the goal are never worth opening
+				if (next.closed || next.value == HexGraph::INFINITE_COST)
+					continue;
+
+				unsigned int given = label.given + graph->getWeight(neighbor);
+				if (given < next.given)
+				{
+					next.given = given;
+					next.parent = tile;
+					open.push_back(std::make_pair(MakeKey(given, next.value), neighbor));
+					std::push_heap(open.begin(), open.end(), later);
+				}
+			}
+		}
+
+		Learn(table, goal);
+
+		if (best < 0)
+			return -1;
+
+		while (labels.find(best)->parent != current)
+			best = labels.find(best)->parent;
+		return best;
+	}
+
+	void RealTimeSearch::Learn(HeuristicTable& table, int goal)
+	{
+		for (size_t i = 0; i < closed.size(); ++i)
+			labels.find(closed[i])->value = HexGraph::INFINITE_COST;
+
+		// Dijkstra search from the frontier back into the expanded tiles.  Stepping onto a
+		// tile costs its weight, so a tile's value bounds its neighbors' through it.
+		frontier.clear();
+		for (size_t i = 0; i < open.size(); ++i)
+		{
+			Label const& label = *labels.find(open[i].second);
+			if (!label.closed && open[i].first == MakeKey(label.given, label.value))
+				frontier.push_back(std::make_pair(label.value, open[i].second));
+		}
+
+		std::greater<std::pair<unsigned int, int> > const later;
+		std::make_heap(frontier.begin(), frontier.end(), later);
+
+		while (!frontier.empty())
+		{
+			std::pop_heap(frontier.begin(), frontier.end(), later);
+			std::pair<unsigned int, int> top = frontier.back();
+			frontier.pop_back();
+
+			int tile = top.second;
+			if (top.first != labels.find(tile)->value)
+				continue;
+
+			unsigned int value = top.first + graph->getWeight(tile);
+			for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+			{
+				int neighbor = graph->getNeighbor(tile, d);
+				if (neighbor < 0)
+					continue;
+
+				// Tiles the lookahead never reached have no label
+				Label* previous = labels.find(neighbor);
+				if (previous != 0 && previous->closed && value < previous->value)
+				{
+					previous->value = value;
+					frontier.push_back(std::make_pair(value, neighbor));
+					std::push_heap(frontier.begin(), frontier.end(), later);
+				}
+			}
+		}
+
+		// Values only ever rise; tiles with no way out are marked unreachable
+		for (size_t i = 0; i < closed.size(); ++i)
+		{
+			int tile = closed[i];
+			unsigned int value = labels.find(tile)->value;
+			if (value > Estimate(table, tile, goal))
+				table.set(tile, value);
+		}
+	}
+
+	unsigned int RealTimeSearch::getHeuristic(int tile, int goal) const
+	{
+		std::unordered_map<int, HeuristicTable>::const_iterator found = tables.find(goal);
+		return found == tables.end() ? InitialEstimate(tile, goal)
+			: Estimate(found->second, tile, goal);
+	}
+
+	void RealTimeSearch::forgetGoal(int goal)
+	{
+		tables.erase(goal);
+	}
+
+	void RealTimeSearch::forgetAll()
+	{
+		tables.clear();
+	}
+
+	size_t RealTimeSearch::getLearnedCount(int goal) const
+	{
+		std::unordered_map<int, HeuristicTable>::const_iterator found = tables.find(goal);
+		return found == tables.end() ? 0 : found->second.getCount();
+	}
+
+	size_t RealTimeSearch::getMemoryUsage() const
+	{
+		size_t total = 0;
+		for (std::unordered_map<int, HeuristicTable>::const_iterator i = tables.begin();
+			i != tables.end(); ++i)
+			total += i->second.getMemoryUsage();
+		return total;
+	}
+}}  // namespace fullsail_ai::algorithms
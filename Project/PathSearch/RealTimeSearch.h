@@ -0,0 +1,129 @@
+//! \file RealTimeSearch.h
+//! \brief Defines the fullsail_ai::algorithms::RealTimeSearch class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_REAL_TIME_SEARCH_H_
+#define _FULLSAIL_AI_PATH_PLANNER_REAL_TIME_SEARCH_H_
+
+#include <unordered_map>
+#include <vector>
+#include "HexGraph.h"
+#include "HeuristicTable.h"
+#include "Landmarks.h"
+#include "StampedHashTable.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Learning real-time A* (LRTA*) for agents that must move at once and cannot
+	//! afford a full search.
+	//!
+	//! Each <code>step()</code> looks ahead from the agent's tile with an A* search of at
+	//! most <code>getLookahead()</code> expansions.  It then raises the heuristic of every
+	//! tile it expanded to the cheapest cost out through the search frontier, as in LSS-LRTA*,
+	//! and returns the first step toward the most promising frontier tile.  The work of a call
+	//! is bounded by the lookahead whatever the map or query, so its latency has a fixed worst
+	//! case: the learned tables grow by a few slots per insertion, and the lookahead scratch
+	//! is sized for the lookahead up front.  Agents caught in a dead end keep raising its
+	//! heuristic until they walk out of it, and repeated trips to the same goal converge on
+	//! the cheapest path.  Convergence takes many trips under the hex distance alone, and
+	//! few with landmarks.
+	//!
+	//! Learned values are kept per goal in a <code>HeuristicTable</code> holding only the
+	//! tiles whose value rose, and every agent heading to a goal shares them.  The initial
+	//! heuristic is the hex distance times the lowest weight, or a landmark table.  Goals
+	//! outside the agent's connected region are turned down at once, as no amount of
+	//! learning would reach them.
+	//!
+	//! Not safe to call from several threads at once; give each thread its own search.
+	class RealTimeSearch
+	{
+		struct Label
+		{
+			unsigned int given;
+			unsigned int value;
+			int parent;
+			bool closed;
+		};
+
+		HexGraph const* graph;
+		LandmarkTable const* landmarks;
+		int lookahead;
+		// Connected region of each tile, -1 for walls
+		std::vector<int> regions;
+		std::unordered_map<int, HeuristicTable> tables;
+
+		// Lookahead scratch, keyed by tile and sized so that it never grows
+		StampedHashTable<int, Label> labels;
+		std::vector<std::pair<unsigned long long, int> > open;
+		std::vector<std::pair<unsigned int, int> > frontier;
+		std::vector<int> closed;
+		int expandedCount;
+
+		unsigned int InitialEstimate(int tile, int goal) const;
+
+		inline unsigned int Estimate(HeuristicTable const& table, int tile, int goal) const
+		{
+			return table.get(tile, InitialEstimate(tile, goal));
+		}
+
+		//! \brief Raises the learned values of the closed tiles from the frontier.
+		void Learn(HeuristicTable& table, int goal);
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT RealTimeSearch();
+
+		//! \brief Prepares the search for a graph and forgets everything learned.
+		//!
+		//! Labels the connected regions of the graph, one integer per tile; walls placed
+		//! later are not seen until the next call.
+		//!
+		//! \param   _graph      the graph the agents move on; must outlive the search.
+		//! \param   _landmarks  optional landmark tables built for the graph, for a sharper
+		//!                      initial heuristic; must outlive the search.
+		DLLEXPORT void initialize(HexGraph const& _graph, LandmarkTable const* _landmarks = 0);
+
+		//! \brief Sets the most tiles expanded per step.  The default is 32.
+		DLLEXPORT void setLookahead(int _lookahead);
+
+		inline int getLookahead() const
+		{
+			return lookahead;
+		}
+
+		//! \brief Picks the next tile for an agent and learns from the lookahead.
+		//!
+		//! \param   current  index of the agent's tile.
+		//! \param   goal     index of the agent's goal.
+		//! \return  an adjacent passable tile to move to, <code>goal</code> if the agent is
+		//!          already there, or -1 if the goal lies in another region or cannot
+		//!          otherwise be reached.
+		DLLEXPORT int step(int current, int goal);
+
+		//! \brief Returns the heuristic of a tile toward a goal, learned or initial.
+		DLLEXPORT unsigned int getHeuristic(int tile, int goal) const;
+
+		//! \brief Forgets what was learned about one goal.
+		DLLEXPORT void forgetGoal(int goal);
+
+		//! \brief Forgets what was learned about every goal.
+		DLLEXPORT void forgetAll();
+
+		//! \brief Returns the number of tiles with a learned value toward a goal.
+		DLLEXPORT size_t getLearnedCount(int goal) const;
+
+		//! \brief Returns the bytes held by the learned values of every goal.
+		//!
+		//! The region labels, four bytes per tile, and the lookahead scratch are left out.
+		//! The scratch takes about a hundred bytes for each tile a lookahead can reach, six
+		//! per expansion, whatever the size of the map.
+		DLLEXPORT size_t getMemoryUsage() const;
+
+		//! \brief Returns the number of tiles expanded by the last step.
+		inline int getExpandedCount() const
+		{
+			return expandedCount;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_REAL_TIME_SEARCH_H_
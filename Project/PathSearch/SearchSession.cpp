@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include "SearchSession.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	void SearchSession::promise_type::unhandled_exception()
+	{
+		std::terminate();
+	}
+
+	SearchSession::SearchSession()
+		: handle(nullptr)
+	{
+	}
+
+	SearchSession::SearchSession(std::coroutine_handle<promise_type> _handle)
+		: handle(_handle)
+	{
+	}
+
+	SearchSession::SearchSession(SearchSession&& other) noexcept
+		: handle(other.handle)
+	{
+		other.handle = nullptr;
+	}
+
+	SearchSession& SearchSession::operator=(SearchSession&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (handle)
+				handle.destroy();
+			handle = other.handle;
+			other.handle = nullptr;
+		}
+
+		return *this;
+	}
+
+	SearchSession::~SearchSession()
+	{
+		if (handle)
+			handle.destroy();
+	}
+
+	SearchSession SearchSession::create(HexGraph const& graph, int start, int goal,
+		LandmarkTable const* landmarks, CostOverlay const* overlay, double weight)
+	{
+		struct Label
+		{
+			unsigned int cost;
+			int parent;
+			bool closed;
+		};
+
+		// Estimated total, cost so far, tile
+		typedef std::pair<unsigned int, std::pair<unsigned int, int> > Entry;
+
+		Result result;
+		result.cost = HexGraph::INFINITE_COST;
+		result.partial = false;
+		if (!graph.isPassable(start) || !graph.isPassable(goal))
+			co_return std::move(result);
+
+		bool useLandmarks = landmarks != 0 && landmarks->isValidFor(graph)
+			&& (overlay == 0 || !overlay->isLoweringWeights());
+		unsigned int minimumWeight = overlay != 0
+			? overlay->getMinimumWeight() : graph.getMinimumWeight();
+		auto estimate = [&](int tile) -> unsigned int
+		{
+			unsigned int bound = graph.getHexDistance(tile, goal) * minimumWeight;
+			if (useLandmarks)
+			{
+				unsigned int landmarkBound = landmarks->estimate(graph, tile, goal);
+				if (landmarkBound > bound)
+					bound = landmarkBound;
+			}
+			return bound;
+		};
+
+		std::unordered_map<int, Label> labels;
+		std::vector<Entry> open;
+		std::greater<Entry> later;
+
+		// Order by the inflated estimate; partial paths still end by the true one
+		auto inflate = [weight](unsigned int remaining) -> unsigned int
+		{
+			return weight > 1 ? static_cast<unsigned int>(remaining * weight) : remaining;
+		};
+
+		Label startLabel = { 0, -1, false };
+		labels[start] = startLabel;
+		open.push_back(Entry(inflate(estimate(start)), std::make_pair(0u, start)));
+
+		// Visited tile with the lowest estimate, where a partial path ends
+		int closestTile = start;
+		unsigned int closestEstimate = estimate(start);
+
+		while (!open.empty())
+		{
+			std::pop_heap(open.begin(), open.end(), later);
+			unsigned int cost = open.back().second.first;
+			int tile = open.back().second.second;
+			open.pop_back();
+
+			// Skip stale entries left behind by cheaper pushes
+			if (cost != labels[tile].cost)
+				continue;
+			labels[tile].closed = true;
+
+			if (tile == goal)
+			{
+				result.cost = cost;
+				for (int t = goal; t >= 0; t = labels[t].parent)
+					result.path.push_back(t);
+				co_return std::move(result);
+			}
+
+			for (int d = 0; d < HexGraph::DIRECTION_COUNT; ++d)
+			{
+				int neighbor = graph.getNeighbor(tile, d);
+				if (neighbor < 0)
+					continue;
+
+				unsigned int step = overlay != 0
+					? overlay->getCost(graph, neighbor) : graph.getWeight(neighbor);
+				if (step == HexGraph::INFINITE_COST)
+					continue;
+
+				unsigned int next = cost + step;
+				// An inflated search keeps its bound without reopening expanded tiles, and
+				// reopening them could cost it more expansions than an optimal search
+				auto found = labels.find(neighbor);
+				if (found == labels.end()
+					|| (next < found->second.cost && (weight <= 1 || !found->second.closed)))
+				{
+					Label label = { next, tile, false };
+					labels[neighbor] = label;
+					unsigned int remaining = estimate(neighbor);
+					open.push_back(Entry(next + inflate(remaining), std::make_pair(next, neighbor)));
+					std::push_heap(open.begin(), open.end(), later);
+
+					if (remaining < closestEstimate
+						|| (remaining == closestEstimate && next < labels[closestTile].cost))
+					{
+						closestTile = neighbor;
+						closestEstimate = remaining;
+					}
+				}
+			}
+
+			if (co_await Expansion())
+			{
+				result.cost = labels[closestTile].cost;
+				result.partial = true;
+				for (int t = closestTile; t >= 0; t = labels[t].parent)
+					result.path.push_back(t);
+				co_return std::move(result);
+			}
+		}
+
+		co_return std::move(result);
+	}
+
+	bool SearchSession::resume(unsigned int budget)
+	{
+		if (isDone() || budget == 0)
+			return isDone();
+
+		handle.promise().budget = budget;
+		handle.resume();
+		return handle.done();
+	}
+
+	void SearchSession::finish()
+	{
+		if (isDone())
+			return;
+
+		handle.promise().stopRequested = true;
+		handle.promise().budget = 1;
+		handle.resume();
+	}
+
+	bool SearchSession::isDone() const
+	{
+		return !handle || handle.done();
+	}
+
+	bool SearchSession::isPartial() const
+	{
+		return handle && handle.promise().result.partial;
+	}
+
+	unsigned int SearchSession::getCost() const
+	{
+		return handle ? handle.promise().result.cost : HexGraph::INFINITE_COST;
+	}
+
+	unsigned int SearchSession::getExpansionCount() const
+	{
+		return handle ? handle.promise().expansionCount : 0;
+	}
+
+	void SearchSession::getSolution(HexGraph const& graph, std::vector<Tile const*>& path) const
+	{
+		path.clear();
+		if (!handle)
+			return;
+
+		std::vector<int> const& tiles = handle.promise().result.path;
+		for (size_t i = 0; i < tiles.size(); ++i)
+			path.push_back(graph.getTile(tiles[i]));
+	}
+
+	void SearchSession::getSolution(std::vector<int>& path) const
+	{
+		path.clear();
+		if (handle)
+			path = handle.promise().result.path;
+	}
+
+	SessionScheduler::SessionScheduler()
+		: cursor(0)
+	{
+	}
+
+	int SessionScheduler::add(SearchSession&& session)
+	{
+		int id;
+		if (freeIds.empty())
+		{
+			id = static_cast<int>(sessions.size());
+			sessions.push_back(std::move(session));
+			used.push_back(true);
+		}
+		else
+		{
+			id = freeIds.back();
+			freeIds.pop_back();
+			sessions[id] = std::move(session);
+			used[id] = true;
+		}
+
+		if (!sessions[id].isDone())
+			running.push_back(id);
+		return id;
+	}
+
+	void SessionScheduler::remove(int id)
+	{
+		if (id < 0 || id >= static_cast<int>(sessions.size()) || !used[id])
+			return;
+
+		std::vector<int>::iterator found = std::find(running.begin(), running.end(), id);
+		if (found != running.end())
+		{
+			if (static_cast<size_t>(found - running.begin()) < cursor)
+				--cursor;
+			running.erase(found);
+		}
+
+		sessions[id] = SearchSession();
+		used[id] = false;
+		freeIds.push_back(id);
+	}
+
+	unsigned int SessionScheduler::run(unsigned int sessionBudget, unsigned int totalBudget)
+	{
+		unsigned int spent = 0;
+
+		while (!running.empty() && spent < totalBudget)
+		{
+			if (cursor >= running.size())
+				cursor = 0;
+
+			unsigned int budget = totalBudget - spent < sessionBudget
+				? totalBudget - spent : sessionBudget;
+			SearchSession& session = sessions[running[cursor]];
+			unsigned int before = session.getExpansionCount();
+
+			bool done = session.resume(budget);
+			// A turn that finds the goal at once still counts, so the loop always advances
+			unsigned int expanded = session.getExpansionCount() - before;
+			spent += expanded != 0 ? expanded : 1;
+
+			if (done)
+				running.erase(running.begin() + cursor);
+			else
+				++cursor;
+		}
+
+		return spent;
+	}
+}}  // namespace fullsail_ai::algorithms
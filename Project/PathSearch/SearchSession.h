@@ -0,0 +1,240 @@
+//! \file SearchSession.h
+//! \brief Defines the fullsail_ai::algorithms::SearchSession and
+//! fullsail_ai::algorithms::SessionScheduler class interfaces.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_SEARCH_SESSION_H_
+#define _FULLSAIL_AI_PATH_PLANNER_SEARCH_SESSION_H_
+
+#include <coroutine>
+#include <utility>
+#include <vector>
+#include "HexGraph.h"
+#include "Landmarks.h"
+#include "CostOverlay.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief One A* query that can be suspended between any two expansions.
+	//!
+	//! The search is a C++20 coroutine: its open list and visited labels live in the
+	//! coroutine frame, so a session owns nothing but its own query and thousands of them can
+	//! be kept in flight on one thread.  A session does no work until <code>resume()</code>,
+	//! which runs it for a budget of expansions and returns.
+	//!
+	//! The graph, landmark table and overlay passed to <code>create()</code> must outlive the
+	//! session.
+	class SearchSession
+	{
+	public:
+		//! \brief Awaited by the search after every expansion.
+		struct Expansion
+		{
+		};
+
+		//! \brief The value a finished search hands back to its session.
+		struct Result
+		{
+			unsigned int cost;
+			//! Tile indices, goal first, start last.
+			std::vector<int> path;
+			//! True if the search was stopped early and the path ends short of the goal.
+			bool partial;
+		};
+
+		//! \brief Coroutine promise; holds the budget and the result.
+		struct promise_type
+		{
+			unsigned int budget;
+			unsigned int expansionCount;
+			bool stopRequested;
+			Result result;
+
+			//! \brief Suspends the search when the budget of the current resume is spent.
+			struct Checkpoint
+			{
+				promise_type& promise;
+
+				inline bool await_ready() const noexcept
+				{
+					return promise.budget != 0 || promise.stopRequested;
+				}
+
+				inline void await_suspend(std::coroutine_handle<promise_type>) const noexcept
+				{
+				}
+
+				//! \return  true if the search must stop and return its best partial path.
+				inline bool await_resume() const noexcept
+				{
+					return promise.stopRequested;
+				}
+			};
+
+			promise_type()
+				: budget(0), expansionCount(0), stopRequested(false)
+			{
+				result.cost = HexGraph::INFINITE_COST;
+				result.partial = false;
+			}
+
+			SearchSession get_return_object()
+			{
+				return SearchSession(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			// Started lazily by the first resume()
+			std::suspend_always initial_suspend() noexcept
+			{
+				return std::suspend_always();
+			}
+
+			// Kept alive after finishing so the result can be read
+			std::suspend_always final_suspend() noexcept
+			{
+				return std::suspend_always();
+			}
+
+			void return_value(Result&& _result)
+			{
+				result = std::move(_result);
+			}
+
+			void unhandled_exception();
+
+			Checkpoint await_transform(Expansion)
+			{
+				++expansionCount;
+				--budget;
+				Checkpoint checkpoint = { *this };
+				return checkpoint;
+			}
+		};
+
+	private:
+		std::coroutine_handle<promise_type> handle;
+
+		explicit SearchSession(std::coroutine_handle<promise_type> _handle);
+
+		SearchSession(SearchSession const&);
+		SearchSession& operator=(SearchSession const&);
+
+	public:
+		//! \brief Creates an empty session that is already done and found nothing.
+		DLLEXPORT SearchSession();
+
+		DLLEXPORT SearchSession(SearchSession&& other) noexcept;
+		DLLEXPORT SearchSession& operator=(SearchSession&& other) noexcept;
+
+		//! \brief Destructor.  Destroys the coroutine frame, finished or not.
+		DLLEXPORT ~SearchSession();
+
+		//! \brief Creates a suspended A* search between two tiles.
+		//!
+		//! Uses the landmark table when it is valid for the graph and the overlay does not
+		//! lower any weight, otherwise the hex distance times the lowest tile weight.
+		//!
+		//! \param   graph      the graph to search.
+		//! \param   start      index of the start tile.
+		//! \param   goal       index of the goal tile.
+		//! \param   landmarks  optional landmark table built for the graph.
+		//! \param   overlay    optional costs for this query in place of the tile weights.
+		//! \param   weight     how much to inflate the estimate.  Above 1 the search usually
+		//!                     reaches the goal after far fewer expansions, with a path at
+		//!                     most that many times the optimal cost.
+		DLLEXPORT static SearchSession create(HexGraph const& graph, int start, int goal,
+			LandmarkTable const* landmarks = 0, CostOverlay const* overlay = 0,
+			double weight = 1);
+
+		//! \brief Runs the search for at most the specified number of expansions.
+		//!
+		//! \return  true if the search is done.
+		DLLEXPORT bool resume(unsigned int budget);
+
+		//! \brief Stops the search at once, keeping the path to the visited tile that looked
+		//! closest to the goal.
+		//!
+		//! Does nothing if the search is already done.  Afterwards <code>isPartial()</code>
+		//! tells whether the path reaches the goal.
+		DLLEXPORT void finish();
+
+		//! \brief Returns true if the search finished, whether or not it reached the goal.
+		DLLEXPORT bool isDone() const;
+
+		//! \brief Returns true if the search finished at the goal.
+		inline bool isFound() const
+		{
+			return isDone() && !isPartial() && getCost() != HexGraph::INFINITE_COST;
+		}
+
+		//! \brief Returns true if <code>finish()</code> cut the search short of the goal.
+		DLLEXPORT bool isPartial() const;
+
+		//! \brief Returns the cost of the path found, partial or not, or
+		//! <code>HexGraph::INFINITE_COST</code> if there is none.
+		DLLEXPORT unsigned int getCost() const;
+
+		//! \brief Returns the number of tiles expanded so far.
+		DLLEXPORT unsigned int getExpansionCount() const;
+
+		//! \brief Returns the tiles of the path found.
+		//!
+		//! \param   graph  the graph that was searched.
+		//! \param   path   receives the tiles ordered like
+		//!                 <code>PathSearch::getSolution()</code>: goal first, start last.
+		//!                 After <code>finish()</code> the first tile may fall short of the
+		//!                 goal.  Left empty if there is no path.
+		DLLEXPORT void getSolution(HexGraph const& graph, std::vector<Tile const*>& path) const;
+
+		//! \brief Returns the tile indices of the path found, in the same order.
+		DLLEXPORT void getSolution(std::vector<int>& path) const;
+	};
+
+	//! \brief Interleaves many search sessions on the calling thread.
+	//!
+	//! Sessions are resumed in round-robin order, each for the same budget of expansions.
+	//! The order carries over between calls to <code>run()</code>, so a session that was not
+	//! reached in one frame is the first to run in the next and every query keeps making
+	//! progress.
+	class SessionScheduler
+	{
+		std::vector<SearchSession> sessions;
+		std::vector<bool> used;
+		std::vector<int> freeIds;
+		// Ids of unfinished sessions, in round-robin order
+		std::vector<int> running;
+		size_t cursor;
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT SessionScheduler();
+
+		//! \brief Takes ownership of a session.
+		//!
+		//! \return  the id used to read the session and to remove it.
+		DLLEXPORT int add(SearchSession&& session);
+
+		//! \brief Destroys a session, finished or not, and frees its id.
+		DLLEXPORT void remove(int id);
+
+		//! \brief Returns the session with the specified id.
+		inline SearchSession const& get(int id) const
+		{
+			return sessions[id];
+		}
+
+		//! \brief Returns the number of sessions that have not finished.
+		inline size_t getRunningCount() const
+		{
+			return running.size();
+		}
+
+		//! \brief Resumes unfinished sessions in turn.
+		//!
+		//! \param   sessionBudget  the expansions given to each session per turn.
+		//! \param   totalBudget    stop once this many expansions have been spent.
+		//! \return  the number of expansions spent.
+		DLLEXPORT unsigned int run(unsigned int sessionBudget, unsigned int totalBudget);
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_SEARCH_SESSION_H_
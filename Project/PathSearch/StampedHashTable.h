@@ -0,0 +1,224 @@
+//! \file StampedHashTable.h
+//! \brief Defines the fullsail_ai::algorithms::StampedHashTable class template.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_STAMPED_HASH_TABLE_H_
+#define _FULLSAIL_AI_PATH_PLANNER_STAMPED_HASH_TABLE_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Open-addressing hash table from integer keys to values, for tables that are
+	//! emptied and refilled many times.
+	//!
+	//! Keys are spread by Fibonacci hashing and collisions probe linearly.  Every entry
+	//! carries the stamp of the fill that wrote it, so <code>clear()</code> only bumps the
+	//! stamp and the table is reused without touching its memory.
+	//!
+	//! Once a quarter full, the table starts growing into one twice its size.  Each insertion
+	//! that follows builds or moves a fixed number of slots, so no insertion costs more than
+	//! a constant amount, and the table is done growing before it gets half full.
+	//!
+	//! \tparam  Key    an integer type of at most 64 bits.
+	//! \tparam  Value  a copyable type; new entries start value-initialized.
+	template <class Key, class Value>
+	class StampedHashTable
+	{
+		struct Entry
+		{
+			Key key;
+			unsigned int stamp;
+			Value value;
+		};
+
+		// Slots built or moved per insertion while growing.  Building the larger table takes
+		// an eighth of the current size in insertions and filling it a sixteenth, so growth
+		// that starts a quarter full ends before either table is half full.
+		static size_t const GROWTH_STEP = 16;
+		static size_t const NOT_FOUND = ~static_cast<size_t>(0);
+
+		std::vector<Entry> entries;
+		// The table being grown into, empty unless growing; it takes new keys once built
+		std::vector<Entry> next;
+		// Slots of entries already moved into next
+		size_t moved;
+		unsigned int stamp;
+		size_t count;
+		int shift;
+		int initialBits;
+
+		static inline size_t Slot(Key key, int bitShift)
+		{
+			return static_cast<size_t>(
+				(static_cast<unsigned long long>(key) * 0x9E3779B97F4A7C15ull) >> bitShift);
+		}
+
+		inline bool IsMoving() const
+		{
+			return !next.empty() && next.size() == entries.size() * 2;
+		}
+
+		inline size_t Locate(std::vector<Entry> const& table, int bitShift, Key key) const
+		{
+			size_t mask = table.size() - 1;
+
+			for (size_t slot = Slot(key, bitShift); table[slot].stamp == stamp;
+				slot = (slot + 1) & mask)
+			{
+				if (table[slot].key == key)
+					return slot;
+			}
+
+			return NOT_FOUND;
+		}
+
+		void GrowStep()
+		{
+			size_t const size = entries.size() * 2;
+			size_t const mask = size - 1;
+			size_t work = GROWTH_STEP;
+
+			for (; work != 0 && next.size() < size; --work)
+				next.push_back(Entry());
+
+			// A key moves once; keys added since went to the larger table, and keys still
+			// here are updated here
+			for (; work != 0 && next.size() == size && moved < entries.size(); --work, ++moved)
+			{
+				if (entries[moved].stamp != stamp)
+					continue;
+
+				size_t slot = Slot(entries[moved].key, shift - 1);
+				while (next[slot].stamp == stamp)
+					slot = (slot + 1) & mask;
+				next[slot] = entries[moved];
+			}
+
+			if (next.size() == size && moved == entries.size())
+			{
+				entries.swap(next);
+				std::vector<Entry>().swap(next);
+				moved = 0;
+				--shift;
+			}
+		}
+
+	public:
+		//! \brief Creates an empty table.
+		//!
+		//! \param   _initialBits  the table starts with <code>1 << _initialBits</code>
+		//!                        entries.
+		explicit StampedHashTable(int _initialBits = 10)
+			: initialBits(_initialBits)
+		{
+			reset();
+		}
+
+		//! \brief Removes every entry in constant time, keeping the memory.
+		void clear()
+		{
+			++stamp;
+			count = 0;
+
+			// Every entry is stale now, so a larger table that is built can be used at once
+			if (next.capacity() != 0)
+			{
+				if (IsMoving())
+				{
+					entries.swap(next);
+					--shift;
+				}
+
+				std::vector<Entry>().swap(next);
+				moved = 0;
+			}
+
+			// Stamps wrapped around: old entries would look current
+			if (stamp == 0)
+			{
+				entries.assign(entries.size(), Entry());
+				stamp = 1;
+			}
+		}
+
+		//! \brief Removes every entry and releases all but the initial capacity.
+		void reset()
+		{
+			std::vector<Entry>(static_cast<size_t>(1) << initialBits, Entry()).swap(entries);
+			std::vector<Entry>().swap(next);
+			moved = 0;
+			stamp = 1;
+			count = 0;
+			shift = 64 - initialBits;
+		}
+
+		//! \brief Returns the value of a key, or <code>NULL</code> if it has none.
+		inline Value const* find(Key key) const
+		{
+			if (IsMoving())
+			{
+				size_t slot = Locate(next, shift - 1, key);
+				if (slot != NOT_FOUND)
+					return &next[slot].value;
+			}
+
+			size_t slot = Locate(entries, shift, key);
+			return slot != NOT_FOUND ? &entries[slot].value : 0;
+		}
+
+		//! \brief Returns the value of a key, or <code>NULL</code> if it has none.  The
+		//! pointer is valid until the next insertion.
+		inline Value* find(Key key)
+		{
+			return const_cast<Value*>(static_cast<StampedHashTable const*>(this)->find(key));
+		}
+
+		//! \brief Returns the value of a key, adding it if it has none.  The reference is
+		//! valid until the next insertion.
+		//!
+		//! \param   added  set to true if the key was added.
+		Value& insert(Key key, bool& added)
+		{
+			Value* value = find(key);
+			if (value != 0)
+			{
+				added = false;
+				return *value;
+			}
+
+			// Only new keys can grow the table
+			if (next.capacity() == 0 && (count + 1) * 4 > entries.size())
+				next.reserve(entries.size() * 2);
+			if (next.capacity() != 0)
+				GrowStep();
+
+			std::vector<Entry>& table = IsMoving() ? next : entries;
+			int const bitShift = IsMoving() ? shift - 1 : shift;
+			size_t const mask = table.size() - 1;
+			size_t slot = Slot(key, bitShift);
+			while (table[slot].stamp == stamp)
+				slot = (slot + 1) & mask;
+
+			table[slot].key = key;
+			table[slot].stamp = stamp;
+			table[slot].value = Value();
+			++count;
+			added = true;
+			return table[slot].value;
+		}
+
+		//! \brief Returns the number of keys with a value.
+		inline size_t getCount() const
+		{
+			return count;
+		}
+
+		//! \brief Returns the bytes held by the table, and by the one it grows into.
+		inline size_t getMemoryUsage() const
+		{
+			return (entries.capacity() + next.capacity()) * sizeof(Entry);
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_STAMPED_HASH_TABLE_H_
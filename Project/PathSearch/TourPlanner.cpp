@@ -0,0 +1,256 @@
+#include <algorithm>
+#include "TourPlanner.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	namespace
+	{
+		// Missing legs cost more than any real tour, so the heuristics avoid them
+		long long const MISSING_LEG = 1LL << 40;
+
+		// Leg costs between stops, with missing legs priced high instead of infinite
+		struct TourCosts
+		{
+			DistanceMatrix const& matrix;
+
+			explicit TourCosts(DistanceMatrix const& _matrix)
+				: matrix(_matrix)
+			{
+			}
+
+			inline long long operator()(int from, int to) const
+			{
+				unsigned int cost = matrix.getCost(from, to);
+				return cost == HexGraph::INFINITE_COST ? MISSING_LEG : cost;
+			}
+		};
+
+		// Reverses tour[i..j] if that makes the tour cheaper.  forward[k] and backward[k]
+		// sum the legs before position k walked each way, so any reversal is priced in
+		// constant time
+		bool TwoOpt(std::vector<int>& tour, int lastMovable, TourCosts const& cost)
+		{
+			int const size = static_cast<int>(tour.size());
+			std::vector<long long> forward(size, 0);
+			std::vector<long long> backward(size, 0);
+			for (int k = 1; k < size; ++k)
+			{
+				forward[k] = forward[k - 1] + cost(tour[k - 1], tour[k]);
+				backward[k] = backward[k - 1] + cost(tour[k], tour[k - 1]);
+			}
+
+			for (int i = 1; i < lastMovable; ++i)
+			{
+				for (int j = i + 1; j <= lastMovable; ++j)
+				{
+					long long before = cost(tour[i - 1], tour[i]) + forward[j] - forward[i];
+					long long after = cost(tour[i - 1], tour[j]) + backward[j] - backward[i];
+					if (j + 1 < size)
+					{
+						before += cost(tour[j], tour[j + 1]);
+						after += cost(tour[i], tour[j + 1]);
+					}
+
+					if (after < before)
+					{
+						for (int a = i, b = j; a < b; ++a, --b)
+							std::swap(tour[a], tour[b]);
+						return true;
+					}
+				}
+			}
+
+			return false;
+		}
+
+		// Moves one to three consecutive stops between two others if that makes the tour
+		// cheaper
+		bool OrOpt(std::vector<int>& tour, int lastMovable, TourCosts const& cost)
+		{
+			int const size = static_cast<int>(tour.size());
+
+			for (int length = 1; length <= 3; ++length)
+			{
+				for (int i = 1; i + length - 1 <= lastMovable; ++i)
+				{
+					int first = tour[i];
+					int last = tour[i + length - 1];
+					int after = i + length < size ? tour[i + length] : -1;
+
+					long long removed = cost(tour[i - 1], first);
+					if (after >= 0)
+						removed += cost(last, after) - cost(tour[i - 1], after);
+
+					// Insert after position p, outside the segment and its predecessor
+					for (int p = 0; p <= lastMovable; ++p)
+					{
+						if (p >= i - 1 && p < i + length)
+							continue;
+
+						int next = p + 1 < size ? tour[p + 1] : -1;
+						long long added = cost(tour[p], first);
+						if (next >= 0)
+							added += cost(last, next) - cost(tour[p], next);
+
+						if (added < removed)
+						{
+							std::vector<int> segment(tour.begin() + i, tour.begin() + i + length);
+							tour.erase(tour.begin() + i, tour.begin() + i + length);
+							int insertAt = p < i ? p + 1 : p + 1 - length;
+							tour.insert(tour.begin() + insertAt, segment.begin(), segment.end());
+							return true;
+						}
+					}
+				}
+			}
+
+			return false;
+		}
+	}
+
+	TourPlanner::TourPlanner()
+	{
+	}
+
+	void TourPlanner::FindStops(std::vector<int> const& waypoints)
+	{
+		stops.clear();
+		waypointStops.assign(waypoints.size(), -1);
+
+		for (int w = 0; w < static_cast<int>(waypoints.size()); ++w)
+		{
+			for (int s = 0; s < static_cast<int>(stops.size()) && waypointStops[w] < 0; ++s)
+			{
+				if (stops[s] == waypoints[w])
+					waypointStops[w] = s;
+			}
+
+			if (waypointStops[w] < 0)
+			{
+				waypointStops[w] = static_cast<int>(stops.size());
+				stops.push_back(waypoints[w]);
+			}
+		}
+	}
+
+	unsigned int TourPlanner::Stitch(HexGraph const& graph, bool closed,
+		std::vector<Tile const*>& path) const
+	{
+		path.clear();
+		if (order.empty())
+			return HexGraph::INFINITE_COST;
+
+		std::vector<int> visits;
+		for (int k = 0; k < static_cast<int>(order.size()); ++k)
+			visits.push_back(waypointStops[order[k]]);
+		if (closed)
+			visits.push_back(visits[0]);
+
+		if (visits.size() == 1)
+		{
+			path.push_back(graph.getTile(stops[visits[0]]));
+			return 0;
+		}
+
+		// Legs come target first, so join them from the last, dropping the tile each shares
+		// with the leg after it
+		unsigned int total = 0;
+		std::vector<Tile const*> leg;
+		for (int k = static_cast<int>(visits.size()) - 2; k >= 0; --k)
+		{
+			unsigned int cost = matrix.extractPath(graph, visits[k], visits[k + 1], leg);
+			if (cost == HexGraph::INFINITE_COST)
+			{
+				path.clear();
+				return HexGraph::INFINITE_COST;
+			}
+
+			total += cost;
+			path.insert(path.end(), path.empty() ? leg.begin() : leg.begin() + 1, leg.end());
+		}
+
+		return total;
+	}
+
+	unsigned int TourPlanner::planOrdered(HexGraph const& graph,
+		std::vector<int> const& waypoints, bool closed, std::vector<Tile const*>& path,
+		unsigned int threadCount)
+	{
+		FindStops(waypoints);
+
+		// Each stop searches only for the stops that follow it
+		std::vector<std::vector<int> > legs(stops.size());
+		int const visitCount = static_cast<int>(waypoints.size());
+		for (int w = 0; w + 1 < visitCount || (closed && w < visitCount); ++w)
+		{
+			std::vector<int>& columns = legs[waypointStops[w]];
+			int next = waypointStops[(w + 1) % visitCount];
+			if (std::find(columns.begin(), columns.end(), next) == columns.end())
+				columns.push_back(next);
+		}
+
+		matrix.compute(graph, stops, stops, legs, true, threadCount);
+
+		order.resize(waypoints.size());
+		for (int w = 0; w < static_cast<int>(order.size()); ++w)
+			order[w] = w;
+
+		return Stitch(graph, closed, path);
+	}
+
+	unsigned int TourPlanner::planUnordered(HexGraph const& graph,
+		std::vector<int> const& waypoints, bool closed, std::vector<Tile const*>& path,
+		unsigned int threadCount)
+	{
+		if (waypoints.empty())
+		{
+			order.clear();
+			path.clear();
+			return HexGraph::INFINITE_COST;
+		}
+
+		// 2-opt and Or-opt price legs between any two stops
+		FindStops(waypoints);
+		matrix.compute(graph, stops, stops, true, threadCount);
+
+		int const stopCount = static_cast<int>(stops.size());
+		TourCosts cost(matrix);
+
+		// Nearest neighbor from the start
+		std::vector<int> tour(1, 0);
+		std::vector<bool> visited(stopCount, false);
+		visited[0] = true;
+		for (int k = 1; k < stopCount; ++k)
+		{
+			int best = -1;
+			for (int s = 0; s < stopCount; ++s)
+			{
+				if (!visited[s] && (best < 0 || cost(tour.back(), s) < cost(tour.back(), best)))
+					best = s;
+			}
+
+			visited[best] = true;
+			tour.push_back(best);
+		}
+
+		// The start stays first, and a closed tour ends on it too
+		if (closed)
+			tour.push_back(0);
+		int lastMovable = stopCount - 1;
+
+		bool improved = stopCount > 2;
+		while (improved)
+			improved = TwoOpt(tour, lastMovable, cost) || OrOpt(tour, lastMovable, cost);
+
+		// Report each stop by the first waypoint on it
+		std::vector<int> stopWaypoints(stopCount, -1);
+		for (int w = static_cast<int>(waypoints.size()) - 1; w >= 0; --w)
+			stopWaypoints[waypointStops[w]] = w;
+
+		order.clear();
+		for (int k = 0; k < stopCount; ++k)
+			order.push_back(stopWaypoints[tour[k]]);
+
+		return Stitch(graph, closed, path);
+	}
+}}  // namespace fullsail_ai::algorithms
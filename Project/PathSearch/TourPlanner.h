@@ -0,0 +1,86 @@
+//! \file TourPlanner.h
+//! \brief Defines the fullsail_ai::algorithms::TourPlanner class interface.
+#ifndef _FULLSAIL_AI_PATH_PLANNER_TOUR_PLANNER_H_
+#define _FULLSAIL_AI_PATH_PLANNER_TOUR_PLANNER_H_
+
+#include <vector>
+#include "HexGraph.h"
+#include "DistanceMatrix.h"
+#include "../platform.h"
+
+namespace fullsail_ai { namespace algorithms {
+
+	//! \brief Plans routes through several waypoints, such as patrols and deliveries.
+	//!
+	//! The search tree of each distinct waypoint is grown once, in parallel with the others,
+	//! by a <code>DistanceMatrix</code> with paths; every leg leaving that waypoint is then
+	//! read off its tree, so waypoints visited several times and legs sharing a start cost
+	//! no extra search.  An ordered tour grows each tree only until the waypoints it leads
+	//! to are reached, while an unordered one needs the legs between every two waypoints.
+	//!
+	//! An ordered tour visits the waypoints as listed.  An unordered tour starts at the first
+	//! waypoint and visits the others in an order found by nearest neighbor, then improved by
+	//! 2-opt (reversing a stretch of the tour) and Or-opt (moving one to three consecutive
+	//! stops elsewhere) until neither helps.  Costs are not symmetric, since a move costs the
+	//! weight of the tile entered, and both improvements account for that.
+	//!
+	//! Pass <code>PathSearch::getGraph()</code> to plan on the map a search is using.
+	class TourPlanner
+	{
+		DistanceMatrix matrix;
+		// Distinct waypoint tiles, and the stop of each waypoint
+		std::vector<int> stops;
+		std::vector<int> waypointStops;
+		std::vector<int> order;
+
+		//! \brief Finds the distinct waypoints.
+		void FindStops(std::vector<int> const& waypoints);
+
+		//! \brief Joins the legs between consecutive stops of <code>order</code>.
+		unsigned int Stitch(HexGraph const& graph, bool closed,
+			std::vector<Tile const*>& path) const;
+
+	public:
+		//! \brief Default constructor.
+		DLLEXPORT TourPlanner();
+
+		//! \brief Plans a tour through the waypoints in the order given.
+		//!
+		//! \param   graph        the graph to search.
+		//! \param   waypoints    indices of the tiles to visit, start first.
+		//! \param   closed       true to return to the first waypoint at the end.
+		//! \param   path         receives the whole tour ordered like
+		//!                       <code>PathSearch::getSolution()</code>: the last tile first,
+		//!                       the start last.  Left empty if a leg has no path.
+		//! \param   threadCount  the number of threads, or 0 to use every hardware thread.
+		//! \return  the cost of the tour, or <code>HexGraph::INFINITE_COST</code>.
+		DLLEXPORT unsigned int planOrdered(HexGraph const& graph,
+			std::vector<int> const& waypoints, bool closed, std::vector<Tile const*>& path,
+			unsigned int threadCount = 0);
+
+		//! \brief Plans a cheap tour that starts at the first waypoint and visits every other
+		//! waypoint once, in any order.
+		//!
+		//! Parameters and result are those of <code>planOrdered()</code>; the order chosen is
+		//! available from <code>getOrder()</code>.  Waypoints listed twice are visited once.
+		DLLEXPORT unsigned int planUnordered(HexGraph const& graph,
+			std::vector<int> const& waypoints, bool closed, std::vector<Tile const*>& path,
+			unsigned int threadCount = 0);
+
+		//! \brief Returns the order the last tour visits the waypoints in, as positions in
+		//! the list it was given, start first and without the return to it.
+		inline std::vector<int> const& getOrder() const
+		{
+			return order;
+		}
+
+		//! \brief Returns the matrix between the distinct waypoints of the last tour.  After
+		//! an ordered tour only the legs it takes are sure to be filled.
+		inline DistanceMatrix const& getMatrix() const
+		{
+			return matrix;
+		}
+	};
+}}  // namespace fullsail_ai::algorithms
+
+#endif  // _FULLSAIL_AI_PATH_PLANNER_TOUR_PLANNER_H_
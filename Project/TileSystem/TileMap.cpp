@@ -4,13 +4,14 @@ namespace fullsail_ai {
 
 	TileMap::TileMap()
 		: row_count(0), column_count(0), tiles(0), tile_radius(0.0), weight_sum_squared(0)
+		, channel_count(0), attributes(0)
 	{
 	}
 
 	TileMap::TileMap(TileMap const& copy)
 		: row_count(copy.row_count), column_count(copy.column_count)
 		, tiles(new Tile*[row_count * column_count]), tile_radius(copy.tile_radius)
-		, weight_sum_squared(copy.weight_sum_squared)
+		, weight_sum_squared(copy.weight_sum_squared), channel_count(0), attributes(0)
 	{
 		int n = row_count * column_count;
 
@@ -19,6 +20,8 @@ namespace fullsail_ai {
 			--n;
 			tiles[n] = new Tile(*copy.tiles[n]);
 		}
+
+		copyAttributes(copy);
 	}
 
 	TileMap& TileMap::operator=(TileMap const& copy)
@@ -39,7 +42,7 @@ namespace fullsail_ai {
 			}
 
 			row_count = copy.row_count;
-			column_count = copy.row_count;
+			column_count = copy.column_count;
 			tiles = new Tile*[row_count * column_count];
 			tile_radius = copy.tile_radius;
 			weight_sum_squared = copy.weight_sum_squared;
@@ -51,11 +54,32 @@ namespace fullsail_ai {
 				--n;
 				tiles[n] = new Tile(*copy.tiles[n]);
 			}
+
+			copyAttributes(copy);
 		}
 
 		return *this;
 	}
 
+	void TileMap::copyAttributes(TileMap const& copy)
+	{
+		delete[] attributes;
+		attributes = 0;
+		channel_count = copy.channel_count;
+
+		if (copy.attributes)
+		{
+			int n = row_count * column_count * channel_count;
+			attributes = new unsigned char[n];
+
+			while (n)
+			{
+				--n;
+				attributes[n] = copy.attributes[n];
+			}
+		}
+	}
+
 	TileMap::~TileMap()
 	{
 		reset();
@@ -80,6 +104,9 @@ namespace fullsail_ai {
 			tiles = 0;
 		}
 
+		delete[] attributes;
+		attributes = 0;
+		channel_count = 0;
 		weight_sum_squared = 0;
 	}
 
@@ -114,6 +141,24 @@ namespace fullsail_ai {
 		tiles[row * column_count + column] = new Tile(row, column, tile_radius, data);
 	}
 
+	void TileMap::createChannels(int num_channels)
+	{
+		delete[] attributes;
+		attributes = 0;
+		channel_count = num_channels;
+
+		if (num_channels > 0)
+		{
+			int n = row_count * column_count * channel_count;
+			attributes = new unsigned char[n];
+
+			while (n)
+			{
+				attributes[--n] = 0;
+			}
+		}
+	}
+
 	Tile* TileMap::getTile(int row, int column) const
 	{
 		if ((0 <= row) && (0 <= column) && (row < row_count) && (column < column_count))
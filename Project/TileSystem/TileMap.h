@@ -20,6 +20,10 @@ namespace fullsail_ai {
 		Tile** tiles;
 		double tile_radius;
 		unsigned int weight_sum_squared;
+		int channel_count;
+		unsigned char* attributes;
+
+		void copyAttributes(TileMap const& copy);
 
 	public:
 		//! \brief Constructs a new <code>%TileMap</code> object.
@@ -43,7 +47,7 @@ namespace fullsail_ai {
 		DLLEXPORT ~TileMap();
 
 		//! \brief Cleans up the underlying tiles and array memory.  Also zeroes the row count,
-		//! the column count, and the tile radius.
+		//! the column count, the tile radius, and the attribute channel count.
 		//!
 		//! The application must reset any search algorithms using this tile map after invoking
 		//! this method.
@@ -83,6 +87,50 @@ namespace fullsail_ai {
 		//!          coordinates are out of bounds.
 		DLLEXPORT Tile* getTile(int row, int column) const;
 
+		//! \brief Creates per-tile attribute channels, such as terrain type, elevation or
+		//! hazard, all set to zero.
+		//!
+		//! Each tile's channels are packed next to each other, and the tiles follow each
+		//! other in row-major order, in one contiguous array.  Any previous channels are
+		//! discarded.
+		//!
+		//! \param   num_channels  the number of attributes per tile; zero removes them.
+		//!
+		//! \pre
+		//!   - The underlying tile array must not be <code>NULL</code>.
+		DLLEXPORT void createChannels(int num_channels);
+
+		//! \brief Sets one attribute of the tile at the specified location.
+		//!
+		//! \pre
+		//!   - The coordinates and channel must be in bounds.
+		inline void setAttribute(int row, int column, int channel, unsigned char value)
+		{
+			attributes[(row * column_count + column) * channel_count + channel] = value;
+		}
+
+		//! \brief Returns one attribute of the tile at the specified location.
+		//!
+		//! \pre
+		//!   - The coordinates and channel must be in bounds.
+		inline unsigned char getAttribute(int row, int column, int channel) const
+		{
+			return attributes[(row * column_count + column) * channel_count + channel];
+		}
+
+		//! \brief Returns the channels of the tile at the specified location, or
+		//! <code>NULL</code> if the map has none.
+		inline unsigned char const* getAttributes(int row, int column) const
+		{
+			return attributes ? attributes + (row * column_count + column) * channel_count : 0;
+		}
+
+		//! \brief Returns the number of attribute channels per tile.
+		inline int getChannelCount() const
+		{
+			return channel_count;
+		}
+
 		//! \brief Computes the square of all tile weights added together.
 		//!
 		//! The application must reset any search algorithms using this tile map after invoking